@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include "vector.h"
+
+//Allocator whose blocks start on an Alignment boundary, e.g. 32 or 64 bytes,
+//so vector loads never straddle a cache line. Alignment is at least alignof(T),
+//by default a cache line or alignof(T) if that is larger; rebinding to a more
+//strictly aligned type keeps the stronger of the two.
+template <class T, std::size_t Alignment = (alignof(T) > 64 ? alignof(T) : 64)>
+class AlignedAllocator {
+public:
+	static_assert(Alignment > 0 && (Alignment & (Alignment - 1)) == 0, "alignment must be a power of two");
+	static_assert(Alignment >= alignof(T), "alignment must not be below alignof(T)");
+
+	static constexpr std::size_t alignment = Alignment;
+
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	template <class U>
+	struct rebind {
+		using other = AlignedAllocator<U, (Alignment > alignof(U) ? Alignment : alignof(U))>;
+	};
+
+	AlignedAllocator() noexcept = default;
+	//only from an allocator that rebinds to this one, so both free each other's blocks
+	template <class U, std::size_t A, class = typename std::enable_if<(A > alignof(T) ? A : alignof(T)) == Alignment>::type>
+	AlignedAllocator(const AlignedAllocator<U, A>&) noexcept;
+
+	T* allocate(std::size_t n);
+	void deallocate(T* pointer, std::size_t n) noexcept;
+
+	template <class U, std::size_t A, class F, std::size_t B>
+	friend bool operator==(const AlignedAllocator<U, A>&, const AlignedAllocator<F, B>&) noexcept;
+
+	template <class U, std::size_t A, class F, std::size_t B>
+	friend bool operator!=(const AlignedAllocator<U, A>&, const AlignedAllocator<F, B>&) noexcept;
+};
+
+//Vector whose data() is aligned to Alignment through reserve, resize and shrink_to_fit
+template <class T, std::size_t Alignment = (alignof(T) > 64 ? alignof(T) : 64), class GrowthPolicy = OneAndHalfGrowth,
+	class BoundsCheck = DefaultBoundsCheck>
+using AlignedVector = Vector<T, AlignedAllocator<T, Alignment>, GrowthPolicy, BoundsCheck>;
+
+template <class T, std::size_t Alignment>
+template <class U, std::size_t A, class>
+AlignedAllocator<T, Alignment>::AlignedAllocator(const AlignedAllocator<U, A>&) noexcept {}
+
+template <class T, std::size_t Alignment>
+T* AlignedAllocator<T, Alignment>::allocate(std::size_t n) {
+	if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+		throw std::bad_alloc();
+	}
+	return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+}
+
+template <class T, std::size_t Alignment>
+void AlignedAllocator<T, Alignment>::deallocate(T* pointer, std::size_t /*n*/) noexcept {
+	::operator delete(pointer, std::align_val_t(Alignment));
+}
+
+//blocks are freed with the alignment they were allocated with,
+//so only allocators of the same alignment free each other's
+template <class U, std::size_t A, class F, std::size_t B>
+bool operator==(const AlignedAllocator<U, A>&, const AlignedAllocator<F, B>&) noexcept {
+	return A == B;
+}
+
+template <class U, std::size_t A, class F, std::size_t B>
+bool operator!=(const AlignedAllocator<U, A>&, const AlignedAllocator<F, B>&) noexcept {
+	return A != B;
+}
\ No newline at end of file
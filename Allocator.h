@@ -1,92 +1,194 @@
 #pragma once
 
 #include <cstring>
-#include <array>
-
-template <class T >
+#include <cassert>
+#include <new>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include "PoolArena.h"
+#include "ConcurrentPoolArena.h"
+#include "LockFreePoolArena.h"
+
+//Pool allocator: any n is served from the power-of-two size classes of a
+//PoolArena, so it backs node containers and Vector storage alike.
+//The arena is shared: copies and rebound allocators refer to the same pool,
+//and it lives until the last of them is gone.
+//Arena is PoolArena for single-threaded use, ConcurrentPoolArena or
+//LockFreePoolArena when copies of the allocator are used from several threads.
+template <class T, class Arena = PoolArena>
 class Allocator {
 public:
+	//blocks handed between the arena and a bulk call per step
+	static constexpr size_t bulk_batch_size = 64;
+
 	using value_type = T;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	using is_always_equal = std::false_type;
 
-	Allocator() noexcept;
+	Allocator();
+	explicit Allocator(std::shared_ptr<Arena> arena) noexcept;
 	Allocator(const Allocator&) noexcept;
 	template<typename U>
-	Allocator(const Allocator<U> &);
-	~Allocator();
+	Allocator(const Allocator<U, Arena> &) noexcept;
+	Allocator& operator=(const Allocator&) noexcept;
 	T* allocate(size_t n);
 	void deallocate(T* pointer, size_t n);
-private:
-	static constexpr size_t max_size = 67108864;
-	size_t pool_size;
-	T* pool;
-	T** blocks;
-	size_t free_index;
-};
+	void allocate_bulk(size_t n, T** pointers);
+	void deallocate_bulk(T* const* pointers, size_t n);
+	bool try_expand(T* pointer, size_t old_n, size_t new_n) noexcept;
 
-template<class T>
-Allocator<T>::Allocator() noexcept {
-	pool_size = max_size / sizeof(T);
-	pool = reinterpret_cast<T*>(new char[pool_size * sizeof(T)]);
+	typename Arena::stats_type stats() const;
+	std::size_t trim();
+	std::size_t maybe_trim();
+	const std::shared_ptr<Arena>& shared_arena() const noexcept;
 
-	blocks = new T*[pool_size];
+	template<class U, class F, class A>
+	friend bool operator==(const Allocator<U, A>& lhs, const Allocator<F, A>& rhs) noexcept;
 
-	for (size_t i = 0; i < pool_size; i++) {
-		blocks[i] = pool + i;
-	}
+	template<class U, class F, class A>
+	friend bool operator!=(const Allocator<U, A>& lhs, const Allocator<F, A>& rhs) noexcept;
 
-	free_index = 0;
-}
+private:
+	template<class U, class A>
+	friend class Allocator;
 
-template<class T>
-Allocator<T>::Allocator(const Allocator& other) noexcept {
-	delete[] pool;
-	delete[] blocks;
+	std::shared_ptr<Arena> arena;
+};
 
-	pool_size = other.pool_size;
-	free_index = 0;
+template<class T, class Arena>
+Allocator<T, Arena>::Allocator()
+	: arena(std::make_shared<Arena>()) {}
 
-	pool = reinterpret_cast<T*>(new char[pool_size * sizeof(T)]);
-	blocks = new T*[pool_size];
+//shares an arena set up by the caller, e.g. with another ChunkBacking
+template<class T, class Arena>
+Allocator<T, Arena>::Allocator(std::shared_ptr<Arena> arena) noexcept
+	: arena(std::move(arena)) {}
 
-	std::memcpy(pool, other.pool, pool_size * sizeof(T));
-	std::memcpy(blocks, other.blocks, pool_size);
-}	
+//there is no move constructor on purpose: a moved-from allocator must still
+//be able to free the blocks it handed out
+template<class T, class Arena>
+Allocator<T, Arena>::Allocator(const Allocator& other) noexcept
+	: arena(other.arena) {}
 
-template<class T>
+template<class T, class Arena>
 template<typename U>
-Allocator<T>::Allocator(const Allocator<U> &) {
-	pool_size = max_size / sizeof(T);
-	pool = reinterpret_cast<T*>(new char[pool_size * sizeof(T)]);
+Allocator<T, Arena>::Allocator(const Allocator<U, Arena> & other) noexcept
+	: arena(other.arena) {}
 
-	blocks = new T*[pool_size];
+template<class T, class Arena>
+Allocator<T, Arena>& Allocator<T, Arena>::operator=(const Allocator& other) noexcept {
+	arena = other.arena;
+	return *this;
+}
 
-	for (size_t i = 0; i < pool_size; i++) {
-		blocks[i] = pool + i;
+//a block of n objects is at least alignof(T) bytes, and blocks are aligned to
+//their size up to Arena::alignment
+template<class T, class Arena>
+T* Allocator<T, Arena>::allocate(size_t n) {
+	static_assert(alignof(T) <= Arena::alignment,
+		"T is aligned beyond the arena, use CacheAlignedAllocator or a pool with a larger PoolTraits alignment");
+	if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+		throw std::bad_alloc();
 	}
-
-	free_index = 0;
+	return static_cast<T*>(arena->allocate(n * sizeof(T)));
 }
 
-template<class T>
-Allocator<T>::~Allocator() {
-	delete[] pool;
-	delete[] blocks;
+template<class T, class Arena>
+void Allocator<T, Arena>::deallocate(T* pointer, size_t n) {
+	arena->deallocate(pointer, n * sizeof(T));
 }
 
-template<class T>
-T* Allocator<T>::allocate(size_t n) {
-	if (n > 1 || free_index == pool_size) {
-		throw std::bad_alloc();
+//n separate objects, e.g. the nodes of a list, all of them or none;
+//the arena hands them out a batch at a time instead of one call per object
+template<class T, class Arena>
+void Allocator<T, Arena>::allocate_bulk(size_t n, T** pointers) {
+	static_assert(alignof(T) <= Arena::alignment, "T is aligned beyond the arena");
+	void* batch[bulk_batch_size];
+	size_t done = 0;
+	try {
+		while (done < n) {
+			size_t count = n - done < bulk_batch_size ? n - done : bulk_batch_size;
+			arena->allocate_bulk(sizeof(T), count, batch);
+			for (size_t i = 0; i < count; i++) {
+				pointers[done + i] = static_cast<T*>(batch[i]);
+			}
+			done += count;
+		}
 	}
+	catch (...) {
+		deallocate_bulk(pointers, done);
+		throw;
+	}
+}
 
-	return blocks[free_index++];
+template<class T, class Arena>
+void Allocator<T, Arena>::deallocate_bulk(T* const* pointers, size_t n) {
+	void* batch[bulk_batch_size];
+	for (size_t done = 0; done < n; ) {
+		size_t count = n - done < bulk_batch_size ? n - done : bulk_batch_size;
+		for (size_t i = 0; i < count; i++) {
+			batch[i] = pointers[done + i];
+		}
+		arena->deallocate_bulk(sizeof(T), count, batch);
+		done += count;
+	}
 }
 
-template<class T>
-void Allocator<T>::deallocate(T* pointer, size_t n) {
-	assert(0 <= n && n <= 1);
-	if (n == 0) {
-		return;
+//grows a block without moving it while the new size stays in its size class,
+//Vector calls it through the try_expand hook before reallocating
+template<class T, class Arena>
+bool Allocator<T, Arena>::try_expand(T* pointer, size_t old_n, size_t new_n) noexcept {
+	if (new_n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+		return false;
 	}
-	blocks[--free_index] = pointer;
-}
\ No newline at end of file
+	return arena->try_expand(pointer, old_n * sizeof(T), new_n * sizeof(T));
+}
+
+//snapshot of the shared arena, see PoolStats
+template<class T, class Arena>
+typename Arena::stats_type Allocator<T, Arena>::stats() const {
+	return arena->stats();
+}
+
+//gives free memory of the shared arena back to the system, see PoolArena::trim
+template<class T, class Arena>
+std::size_t Allocator<T, Arena>::trim() {
+	return arena->trim();
+}
+
+//runs a trim deallocate asked for, see PoolArena::set_auto_trim
+template<class T, class Arena>
+std::size_t Allocator<T, Arena>::maybe_trim() {
+	return arena->maybe_trim();
+}
+
+template<class T, class Arena>
+const std::shared_ptr<Arena>& Allocator<T, Arena>::shared_arena() const noexcept {
+	return arena;
+}
+
+//allocators are equal when one can free what the other allocated
+template<class U, class F, class A>
+bool operator==(const Allocator<U, A>& lhs, const Allocator<F, A>& rhs) noexcept {
+	return lhs.arena == rhs.arena;
+}
+
+template<class U, class F, class A>
+bool operator!=(const Allocator<U, A>& lhs, const Allocator<F, A>& rhs) noexcept {
+	return !(lhs == rhs);
+}
+
+//pool allocator whose blocks start on a cache line
+template <class T>
+using CacheAlignedAllocator = Allocator<T, CacheAlignedPoolArena>;
+
+//pool allocator that may be shared between threads
+template <class T>
+using ConcurrentAllocator = Allocator<T, ConcurrentPoolArena>;
+
+//pool allocator that several threads use without locking
+template <class T>
+using LockFreeAllocator = Allocator<T, LockFreePoolArena>;
\ No newline at end of file
@@ -0,0 +1,148 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+//Optional hooks an allocator can offer on top of std::allocator_traits.
+//Vector detects them at compile time and takes the standard path without them.
+
+//bool try_expand(pointer p, size_type old_n, size_type new_n):
+//grows the block at p from old_n to new_n elements without moving it,
+//returns false and leaves the block alone when it can not
+template <class Allocator, class = void>
+struct has_try_expand : std::false_type {};
+
+template <class Allocator>
+struct has_try_expand<Allocator, std::void_t<decltype(std::declval<Allocator&>().try_expand(
+	std::declval<typename std::allocator_traits<Allocator>::pointer>(), std::size_t(), std::size_t()))>>
+	: std::true_type {};
+
+template <class Allocator>
+bool allocator_try_expand(Allocator& alloc, typename std::allocator_traits<Allocator>::pointer pointer,
+	std::size_t old_n, std::size_t new_n) {
+	if constexpr (has_try_expand<Allocator>::value) {
+		return alloc.try_expand(pointer, old_n, new_n);
+	}
+	else {
+		return false;
+	}
+}
+
+//pointer reallocate(pointer p, size_type old_n, size_type new_n):
+//moves the block at p to a block of new_n elements, possibly at the same address,
+//keeping the bytes of the first min(old_n, new_n) elements. Throws and leaves
+//the block alone when it can not. Vector only uses it for trivially relocatable T.
+template <class Allocator, class = void>
+struct has_reallocate : std::false_type {};
+
+template <class Allocator>
+struct has_reallocate<Allocator, std::void_t<decltype(std::declval<Allocator&>().reallocate(
+	std::declval<typename std::allocator_traits<Allocator>::pointer>(), std::size_t(), std::size_t()))>>
+	: std::true_type {};
+
+//pointer allocate_zeroed(size_type n): like allocate(n), but every byte of the
+//block is zero, e.g. a fresh anonymous mapping whose pages are faulted in on first use.
+//The allocator promises its construct(p) only value-initializes, Vector then skips
+//it for types whose value-initialized state is all zero bytes. If it also has
+//try_expand or reallocate, the elements they add past old_n must be zero as well.
+template <class Allocator, class = void>
+struct has_allocate_zeroed : std::false_type {};
+
+template <class Allocator>
+struct has_allocate_zeroed<Allocator, std::void_t<decltype(std::declval<Allocator&>().allocate_zeroed(std::size_t()))>>
+	: std::true_type {};
+
+//trait: a value-initialized T is all zero bytes. Specialize it for own types,
+//e.g. structs of arithmetic members.
+template <class T>
+struct is_trivially_zeroable : std::bool_constant<std::is_arithmetic<T>::value || std::is_enum<T>::value
+	|| std::is_pointer<T>::value> {};
+
+template <class T>
+constexpr bool is_trivially_zeroable_v = is_trivially_zeroable<T>::value;
+
+//void allocate_bulk(size_type n, pointer* out), void deallocate_bulk(const pointer* pointers, size_type n):
+//n separate single objects in one call, e.g. the nodes of a linked structure.
+//allocate_bulk hands out all of them or throws with none allocated.
+template <class Allocator, class = void>
+struct has_allocate_bulk : std::false_type {};
+
+template <class Allocator>
+struct has_allocate_bulk<Allocator, std::void_t<
+	decltype(std::declval<Allocator&>().allocate_bulk(std::size_t(),
+		std::declval<typename std::allocator_traits<Allocator>::pointer*>())),
+	decltype(std::declval<Allocator&>().deallocate_bulk(
+		std::declval<const typename std::allocator_traits<Allocator>::pointer*>(), std::size_t()))>>
+	: std::true_type {};
+
+template <class Allocator>
+void allocator_allocate_bulk(Allocator& alloc, std::size_t n, typename std::allocator_traits<Allocator>::pointer* pointers) {
+	if constexpr (has_allocate_bulk<Allocator>::value) {
+		alloc.allocate_bulk(n, pointers);
+	}
+	else {
+		std::size_t done = 0;
+		try {
+			for (; done < n; done++) {
+				pointers[done] = std::allocator_traits<Allocator>::allocate(alloc, 1);
+			}
+		}
+		catch (...) {
+			for (std::size_t i = 0; i < done; i++) {
+				std::allocator_traits<Allocator>::deallocate(alloc, pointers[i], 1);
+			}
+			throw;
+		}
+	}
+}
+
+template <class Allocator>
+void allocator_deallocate_bulk(Allocator& alloc, const typename std::allocator_traits<Allocator>::pointer* pointers, std::size_t n) {
+	if constexpr (has_allocate_bulk<Allocator>::value) {
+		alloc.deallocate_bulk(pointers, n);
+	}
+	else {
+		for (std::size_t i = 0; i < n; i++) {
+			std::allocator_traits<Allocator>::deallocate(alloc, pointers[i], 1);
+		}
+	}
+}
+
+//allocator_traits::destroy calls the allocator's own destroy when it has one
+template <class Allocator, class T, class = void>
+struct has_destroy : std::false_type {};
+
+template <class Allocator, class T>
+struct has_destroy<Allocator, T, std::void_t<decltype(std::declval<Allocator&>().destroy(std::declval<T*>()))>>
+	: std::true_type {};
+
+//the destroy members of the standard allocators only call the destructor
+template <class Allocator>
+struct is_standard_allocator : std::false_type {};
+
+template <class T>
+struct is_standard_allocator<std::allocator<T>> : std::true_type {};
+
+template <class T>
+struct is_standard_allocator<std::pmr::polymorphic_allocator<T>> : std::true_type {};
+
+//destroying a T through Allocator does nothing, so elements can be dropped without a loop.
+//has_destroy is not looked at for the standard allocators, their destroy is deprecated.
+template <class Allocator, class T>
+constexpr bool is_trivially_destroyed_v = std::conjunction<std::is_trivially_destructible<T>,
+	std::disjunction<is_standard_allocator<Allocator>, std::negation<has_destroy<Allocator, T>>>>::value;
+
+//allocator_traits::construct calls the allocator's own construct(p) when it has one
+template <class Allocator, class T, class = void>
+struct has_construct : std::false_type {};
+
+template <class Allocator, class T>
+struct has_construct<Allocator, T, std::void_t<decltype(std::declval<Allocator&>().construct(std::declval<T*>()))>>
+	: std::true_type {};
+
+//default-initializing a T through Allocator does nothing, so new elements can be left as they are
+template <class Allocator, class T>
+constexpr bool is_trivially_default_initialized_v = std::conjunction<std::is_trivially_default_constructible<T>,
+	std::disjunction<is_standard_allocator<Allocator>, std::negation<has_construct<Allocator, T>>>>::value;
\ No newline at end of file
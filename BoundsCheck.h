@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+//Bounds check policies for Vector::operator[].
+//at() always throws, operator[] checks only as much as the policy says.
+
+//no check at all, operator[] compiles down to a plain pointer access
+struct NoBoundsCheck {
+	static void check(std::size_t /*pos*/, std::size_t /*size*/) noexcept {}
+};
+
+//reports the index and size and aborts in debug builds, does nothing with NDEBUG
+struct AssertBoundsCheck {
+	static void check(std::size_t pos, std::size_t size) noexcept {
+#ifndef NDEBUG
+		if (pos >= size) {
+			fail(pos, size);
+		}
+#endif
+	}
+
+	[[noreturn]] static void fail(std::size_t pos, std::size_t size) noexcept {
+		std::fprintf(stderr, "Vector index %zu is out of range for size %zu\n", pos, size);
+		std::abort();
+	}
+};
+
+//throws std::out_of_range with the index and size
+struct ThrowBoundsCheck {
+	static void check(std::size_t pos, std::size_t size) {
+		if (pos >= size) {
+			fail(pos, size);
+		}
+	}
+
+	[[noreturn]] static void fail(std::size_t pos, std::size_t size) {
+		throw std::out_of_range("Vector index " + std::to_string(pos) + " is out of range for size " + std::to_string(size));
+	}
+};
+
+//default policy, can be chosen for the whole build with
+//-DVECTOR_BOUNDS_CHECK=VECTOR_BOUNDS_CHECK_OFF / _ASSERT / _THROW.
+//Without it operator[] is asserted in debug builds and unchecked with NDEBUG.
+#define VECTOR_BOUNDS_CHECK_OFF 0
+#define VECTOR_BOUNDS_CHECK_ASSERT 1
+#define VECTOR_BOUNDS_CHECK_THROW 2
+
+#ifndef VECTOR_BOUNDS_CHECK
+#ifdef NDEBUG
+#define VECTOR_BOUNDS_CHECK VECTOR_BOUNDS_CHECK_OFF
+#else
+#define VECTOR_BOUNDS_CHECK VECTOR_BOUNDS_CHECK_ASSERT
+#endif
+#endif
+
+#if VECTOR_BOUNDS_CHECK == VECTOR_BOUNDS_CHECK_THROW
+using DefaultBoundsCheck = ThrowBoundsCheck;
+#elif VECTOR_BOUNDS_CHECK == VECTOR_BOUNDS_CHECK_ASSERT
+using DefaultBoundsCheck = AssertBoundsCheck;
+#else
+using DefaultBoundsCheck = NoBoundsCheck;
+#endif
\ No newline at end of file
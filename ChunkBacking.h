@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+//Where PoolArena takes the memory of its chunks from. The flags combine, and
+//every flag other than heap implies mapped.
+//Huge pages cut the TLB misses of random walks over a pool: a 64 MB pool is
+//32 pages of 2 MB instead of 16384 pages of 4 KB.
+struct ChunkBacking {
+	//operator new
+	static constexpr unsigned heap = 0;
+	//anonymous private mapping straight from the OS
+	static constexpr unsigned mapped = 1;
+	//explicit huge pages (MAP_HUGETLB, MEM_LARGE_PAGES); when the system has
+	//none to give, the arena falls back to transparent_huge_pages
+	static constexpr unsigned huge_pages = 2 | mapped;
+	//huge page aligned chunks marked with madvise(MADV_HUGEPAGE), so the
+	//kernel backs them with huge pages whenever it can
+	static constexpr unsigned transparent_huge_pages = 4 | mapped;
+	//fault every page in when the chunk is mapped instead of on first touch
+	static constexpr unsigned populate = 8 | mapped;
+
+	static constexpr std::size_t huge_page_size = 2097152;
+	static constexpr std::size_t page_size = 4096;
+
+	//bytes may be rounded up to whole huge pages, backing loses huge_pages
+	//when the system can not provide them. Mappings are page aligned, heap
+	//chunks get alignment from aligned operator new when they need more than usual.
+	static void* allocate(std::size_t& bytes, unsigned& backing, std::size_t alignment = alignof(std::max_align_t));
+	static void deallocate(void* chunk, std::size_t bytes, unsigned backing,
+		std::size_t alignment = alignof(std::max_align_t)) noexcept;
+	//gives the whole pages inside [begin, begin + bytes) back to the system while
+	//keeping them mapped; they read as zeros or as before when touched again.
+	//Returns the bytes given back, 0 where the system does not support it.
+	static std::size_t discard(void* begin, std::size_t bytes, unsigned backing) noexcept;
+	//resizes a mapping of plain mapped backing. The kernel moves page tables, not
+	//bytes. Without may_move the mapping only changes where it is. Returns nullptr
+	//and leaves the mapping alone when that is not possible or there is no mremap.
+	//Growing, everything past old_bytes reads as zeros.
+	static void* remap(void* chunk, std::size_t old_bytes, std::size_t new_bytes, bool may_move) noexcept;
+
+private:
+	static constexpr unsigned huge_pages_bit = 2;
+	static constexpr unsigned transparent_huge_pages_bit = 4;
+	static constexpr unsigned populate_bit = 8;
+
+	static void* map(std::size_t bytes, unsigned backing) noexcept;
+	static void* map_transparent(std::size_t bytes, unsigned backing) noexcept;
+	static void prefault(void* chunk, std::size_t bytes) noexcept;
+};
+
+inline void* ChunkBacking::allocate(std::size_t& bytes, unsigned& backing, std::size_t alignment) {
+	if ((backing & mapped) == 0) {
+		if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+			return ::operator new(bytes, std::align_val_t(alignment));
+		}
+		return ::operator new(bytes);
+	}
+	if ((backing & (huge_pages_bit | transparent_huge_pages_bit)) != 0) {
+		bytes = (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+	}
+
+	void* chunk = nullptr;
+	if ((backing & huge_pages_bit) != 0) {
+		chunk = map(bytes, backing);
+		if (chunk == nullptr) {
+			backing = (backing & ~huge_pages_bit) | transparent_huge_pages;
+		}
+	}
+	if (chunk == nullptr && (backing & transparent_huge_pages_bit) != 0) {
+		chunk = map_transparent(bytes, backing);
+	}
+	else if (chunk == nullptr) {
+		chunk = map(bytes, backing);
+	}
+	if (chunk == nullptr) {
+		throw std::bad_alloc();
+	}
+	return chunk;
+}
+
+inline void ChunkBacking::deallocate(void* chunk, std::size_t bytes, unsigned backing, std::size_t alignment) noexcept {
+	if ((backing & mapped) == 0) {
+		if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+			::operator delete(chunk, std::align_val_t(alignment));
+			return;
+		}
+		::operator delete(chunk);
+		return;
+	}
+#if defined(_WIN32)
+	VirtualFree(chunk, 0, MEM_RELEASE);
+#elif defined(__unix__) || defined(__APPLE__)
+	munmap(chunk, bytes);
+#else
+	::operator delete(chunk);
+#endif
+}
+
+inline std::size_t ChunkBacking::discard(void* begin, std::size_t bytes, unsigned backing) noexcept {
+#if defined(_WIN32)
+	//MEM_RESET is only valid on VirtualAlloc memory, and large pages can not be reset
+	if ((backing & mapped) == 0 || (backing & huge_pages_bit) != 0) {
+		return 0;
+	}
+	std::size_t page = page_size;
+#elif defined(__unix__) || defined(__APPLE__)
+	//heap chunks are private anonymous memory as well, any backing can be discarded
+	static_cast<void>(backing);
+	long system_page = sysconf(_SC_PAGESIZE);
+	std::size_t page = system_page > 0 ? static_cast<std::size_t>(system_page) : page_size;
+#else
+	static_cast<void>(backing);
+	return 0;
+#endif
+#if defined(_WIN32) || defined(__unix__) || defined(__APPLE__)
+	std::size_t first = (reinterpret_cast<std::size_t>(begin) + page - 1) / page * page;
+	std::size_t last = (reinterpret_cast<std::size_t>(begin) + bytes) / page * page;
+	if (last <= first) {
+		return 0;
+	}
+#if defined(_WIN32)
+	if (VirtualAlloc(reinterpret_cast<void*>(first), last - first, MEM_RESET, PAGE_READWRITE) == nullptr) {
+		return 0;
+	}
+#else
+	//explicit huge pages only take whole huge pages and fail here
+	if (madvise(reinterpret_cast<void*>(first), last - first, MADV_DONTNEED) != 0) {
+		return 0;
+	}
+#endif
+	return last - first;
+#endif
+}
+
+inline void* ChunkBacking::remap(void* chunk, std::size_t old_bytes, std::size_t new_bytes, bool may_move) noexcept {
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+	//new pages are zero, but a shrinking remap left old bytes in the rest of the last page
+	if (new_bytes > old_bytes) {
+		long system_page = sysconf(_SC_PAGESIZE);
+		std::size_t page = system_page > 0 ? static_cast<std::size_t>(system_page) : page_size;
+		std::size_t tail = (page - old_bytes % page) % page;
+		std::memset(static_cast<char*>(chunk) + old_bytes, 0, tail < new_bytes - old_bytes ? tail : new_bytes - old_bytes);
+	}
+	void* moved = mremap(chunk, old_bytes, new_bytes, may_move ? MREMAP_MAYMOVE : 0);
+	return moved == MAP_FAILED ? nullptr : moved;
+#else
+	return nullptr;
+#endif
+}
+
+//plain mapping, with explicit huge pages when backing asks for them
+inline void* ChunkBacking::map(std::size_t bytes, unsigned backing) noexcept {
+#if defined(_WIN32)
+	DWORD type = MEM_RESERVE | MEM_COMMIT;
+	if ((backing & huge_pages_bit) != 0) {
+		//needs SeLockMemoryPrivilege, without it VirtualAlloc fails and we fall back
+		SIZE_T large_page = GetLargePageMinimum();
+		if (large_page == 0 || bytes % large_page != 0) {
+			return nullptr;
+		}
+		type |= MEM_LARGE_PAGES;
+	}
+	return VirtualAlloc(nullptr, bytes, type, PAGE_READWRITE);
+#elif defined(__unix__) || defined(__APPLE__)
+	int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+	if ((backing & huge_pages_bit) != 0) {
+#if defined(MAP_HUGETLB)
+		flags |= MAP_HUGETLB;
+#else
+		return nullptr;
+#endif
+	}
+#if defined(MAP_POPULATE)
+	if ((backing & populate_bit) != 0) {
+		flags |= MAP_POPULATE;
+	}
+#endif
+	void* chunk = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+	if (chunk == MAP_FAILED) {
+		return nullptr;
+	}
+#if !defined(MAP_POPULATE)
+	if ((backing & populate_bit) != 0) {
+		prefault(chunk, bytes);
+	}
+#endif
+	return chunk;
+#else
+	if ((backing & huge_pages_bit) != 0) {
+		return nullptr;
+	}
+	return ::operator new(bytes, std::nothrow);
+#endif
+}
+
+//maps a huge page more than needed and trims both ends, so the chunk starts
+//on a huge page boundary and the kernel can back all of it with huge pages
+inline void* ChunkBacking::map_transparent(std::size_t bytes, unsigned backing) noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+	std::size_t mapped_bytes = bytes + huge_page_size;
+	void* area = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (area == MAP_FAILED) {
+		return nullptr;
+	}
+	char* start = static_cast<char*>(area);
+	char* chunk = reinterpret_cast<char*>((reinterpret_cast<std::size_t>(start) + huge_page_size - 1) / huge_page_size * huge_page_size);
+	if (chunk != start) {
+		munmap(start, chunk - start);
+	}
+	std::size_t tail = mapped_bytes - (chunk - start) - bytes;
+	if (tail != 0) {
+		munmap(chunk + bytes, tail);
+	}
+#if defined(MADV_HUGEPAGE)
+	madvise(chunk, bytes, MADV_HUGEPAGE);
+#endif
+	if ((backing & populate_bit) != 0) {
+		prefault(chunk, bytes);
+	}
+	return chunk;
+#else
+	return map(bytes, backing);
+#endif
+}
+
+//touches one byte per page, after madvise so the faults can take huge pages
+inline void ChunkBacking::prefault(void* chunk, std::size_t bytes) noexcept {
+	volatile char* pages = static_cast<char*>(chunk);
+	for (std::size_t offset = 0; offset < bytes; offset += page_size) {
+		pages[offset] = 0;
+	}
+}
\ No newline at end of file
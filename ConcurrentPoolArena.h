@@ -0,0 +1,394 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+#include "PoolArena.h"
+
+//Thread-safe front-end over a PoolArena shared between threads.
+//Every thread keeps a magazine of free blocks per size class, so most
+//allocations and frees only touch memory of the calling thread. An empty
+//magazine is refilled from the central pool and a full one is half flushed
+//back to it, a batch of blocks per lock.
+//Blocks of one class are interchangeable, so a block freed by another thread
+//than the one that allocated it simply lands in the freeing thread's magazine.
+//The magazines of a thread go back to the central pool when the thread exits.
+class ConcurrentPoolArena {
+public:
+	static constexpr std::size_t magazine_size = 64;
+	static constexpr std::size_t magazine_bytes = 262144;
+	static constexpr std::size_t alignment = PoolArena::alignment;
+
+	using stats_type = PoolArena::stats_type;
+
+	explicit ConcurrentPoolArena(unsigned backing = ChunkBacking::heap);
+	ConcurrentPoolArena(const ConcurrentPoolArena&) = delete;
+	ConcurrentPoolArena& operator=(const ConcurrentPoolArena&) = delete;
+	~ConcurrentPoolArena();
+
+	void* allocate(std::size_t bytes);
+	void deallocate(void* pointer, std::size_t bytes) noexcept;
+	//the calling thread's magazine first, the rest of the batch under one lock
+	void allocate_bulk(std::size_t bytes, std::size_t count, void** blocks);
+	void deallocate_bulk(std::size_t bytes, std::size_t count, void* const* blocks) noexcept;
+	bool try_expand(void* pointer, std::size_t old_bytes, std::size_t new_bytes) noexcept;
+
+	std::size_t reserved_bytes() const;
+	//statistics of the central pool: blocks cached in thread magazines count as in use
+	stats_type stats() const;
+
+	//empties the calling thread's magazines and trims the central pool;
+	//blocks in the magazines of other threads keep their runs
+	std::size_t trim();
+	void set_auto_trim(double trim_below, double rearm_above);
+	//see PoolArena::maybe_trim; thread magazines are left alone
+	std::size_t maybe_trim();
+
+	static std::size_t magazine_capacity(std::size_t index) noexcept;
+
+private:
+	struct Magazine {
+		std::size_t count;
+		void* blocks[magazine_size];
+	};
+
+	//magazines of one thread, only that thread touches them;
+	//owner is cleared under owner_mutex when the arena goes away first
+	struct ThreadCache {
+		std::mutex owner_mutex;
+		ConcurrentPoolArena* owner;
+		std::uint64_t owner_id;
+		Magazine magazines[PoolArena::size_class_count];
+	};
+
+	//caches of every arena the calling thread used, returned on thread exit
+	struct ThreadCaches {
+		std::vector<std::shared_ptr<ThreadCache>> caches;
+		~ThreadCaches();
+	};
+
+	//trivial so it stays usable while other thread_locals are destroyed
+	struct ThreadState {
+		std::uint64_t last_id;
+		ThreadCache* last_cache;
+		bool exited;
+	};
+
+	ThreadCache* local_cache() noexcept;
+	ThreadCache* register_thread();
+	void refill(Magazine& magazine, std::size_t index);
+	void flush(Magazine& magazine, std::size_t index, std::size_t count) noexcept;
+	void release(ThreadCache& cache) noexcept;
+
+	static std::uint64_t next_id() noexcept;
+	static ThreadCaches& thread_caches();
+	static ThreadState& thread_state() noexcept;
+
+	const std::uint64_t id;
+	mutable std::mutex mutex;
+	PoolArena central;
+	std::vector<std::shared_ptr<ThreadCache>> caches;
+};
+
+inline ConcurrentPoolArena::ConcurrentPoolArena(unsigned backing)
+	: id(next_id()), central(backing) {}
+
+//caches of threads that are still running stay with them, only their owner is cleared
+inline ConcurrentPoolArena::~ConcurrentPoolArena() {
+	std::vector<std::shared_ptr<ThreadCache>> registered;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		registered.swap(caches);
+	}
+	for (std::shared_ptr<ThreadCache>& cache : registered) {
+		std::lock_guard<std::mutex> lock(cache->owner_mutex);
+		cache->owner = nullptr;
+	}
+}
+
+inline void* ConcurrentPoolArena::allocate(std::size_t bytes) {
+	if (bytes > PoolArena::max_block_size) {
+		return ::operator new(bytes);
+	}
+
+	std::size_t index = PoolArena::size_class(bytes);
+	ThreadCache* cache = local_cache();
+	if (cache == nullptr) {
+		std::lock_guard<std::mutex> lock(mutex);
+		return central.allocate(PoolArena::block_size(index));
+	}
+	Magazine& magazine = cache->magazines[index];
+	if (magazine.count == 0) {
+		refill(magazine, index);
+	}
+	return magazine.blocks[--magazine.count];
+}
+
+inline void ConcurrentPoolArena::deallocate(void* pointer, std::size_t bytes) noexcept {
+	if (pointer == nullptr) {
+		return;
+	}
+	if (bytes > PoolArena::max_block_size) {
+		::operator delete(pointer);
+		return;
+	}
+
+	std::size_t index = PoolArena::size_class(bytes);
+	ThreadCache* cache = local_cache();
+	if (cache == nullptr) {
+		std::lock_guard<std::mutex> lock(mutex);
+		central.deallocate(pointer, PoolArena::block_size(index));
+		return;
+	}
+	Magazine& magazine = cache->magazines[index];
+	std::size_t capacity = magazine_capacity(index);
+	if (magazine.count == capacity) {
+		flush(magazine, index, capacity / 2);
+	}
+	magazine.blocks[magazine.count++] = pointer;
+}
+
+inline void ConcurrentPoolArena::allocate_bulk(std::size_t bytes, std::size_t count, void** blocks) {
+	if (bytes > PoolArena::max_block_size) {
+		std::size_t done = 0;
+		try {
+			for (; done < count; done++) {
+				blocks[done] = ::operator new(bytes);
+			}
+		}
+		catch (...) {
+			deallocate_bulk(bytes, done, blocks);
+			throw;
+		}
+		return;
+	}
+
+	std::size_t index = PoolArena::size_class(bytes);
+	std::size_t done = 0;
+	ThreadCache* cache = local_cache();
+	if (cache != nullptr) {
+		Magazine& magazine = cache->magazines[index];
+		while (done < count && magazine.count != 0) {
+			blocks[done++] = magazine.blocks[--magazine.count];
+		}
+	}
+	if (done == count) {
+		return;
+	}
+	try {
+		std::lock_guard<std::mutex> lock(mutex);
+		central.allocate_bulk(PoolArena::block_size(index), count - done, blocks + done);
+	}
+	catch (...) {
+		deallocate_bulk(bytes, done, blocks);
+		throw;
+	}
+}
+
+//fills the calling thread's magazine, the rest goes back to the central pool under one lock
+inline void ConcurrentPoolArena::deallocate_bulk(std::size_t bytes, std::size_t count, void* const* blocks) noexcept {
+	if (bytes > PoolArena::max_block_size) {
+		for (std::size_t i = 0; i < count; i++) {
+			::operator delete(blocks[i]);
+		}
+		return;
+	}
+
+	std::size_t index = PoolArena::size_class(bytes);
+	std::size_t done = 0;
+	ThreadCache* cache = local_cache();
+	if (cache != nullptr) {
+		Magazine& magazine = cache->magazines[index];
+		std::size_t capacity = magazine_capacity(index);
+		while (done < count && magazine.count < capacity) {
+			magazine.blocks[magazine.count++] = blocks[done++];
+		}
+	}
+	if (done == count) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	central.deallocate_bulk(PoolArena::block_size(index), count - done, blocks + done);
+}
+
+//blocks stay in their class wherever they are cached, so no lock is needed
+inline bool ConcurrentPoolArena::try_expand(void* pointer, std::size_t old_bytes, std::size_t new_bytes) noexcept {
+	return central.try_expand(pointer, old_bytes, new_bytes);
+}
+
+inline std::size_t ConcurrentPoolArena::reserved_bytes() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return central.reserved_bytes();
+}
+
+inline ConcurrentPoolArena::stats_type ConcurrentPoolArena::stats() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return central.stats();
+}
+
+inline std::size_t ConcurrentPoolArena::trim() {
+	ThreadCache* cache = local_cache();
+	if (cache != nullptr) {
+		for (std::size_t i = 0; i < PoolArena::size_class_count; i++) {
+			flush(cache->magazines[i], i, cache->magazines[i].count);
+		}
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	return central.trim();
+}
+
+inline void ConcurrentPoolArena::set_auto_trim(double trim_below, double rearm_above) {
+	std::lock_guard<std::mutex> lock(mutex);
+	central.set_auto_trim(trim_below, rearm_above);
+}
+
+inline std::size_t ConcurrentPoolArena::maybe_trim() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return central.maybe_trim();
+}
+
+//number of blocks a magazine of the class holds: magazine_size for small
+//blocks, fewer for large ones so a thread does not sit on too much memory
+inline std::size_t ConcurrentPoolArena::magazine_capacity(std::size_t index) noexcept {
+	std::size_t capacity = magazine_bytes / PoolArena::block_size(index);
+	if (capacity > magazine_size) {
+		return magazine_size;
+	}
+	return capacity < 2 ? 2 : capacity;
+}
+
+//cache of the calling thread, nullptr once the thread is exiting or if it
+//could not be registered, callers then go to the central pool directly
+inline ConcurrentPoolArena::ThreadCache* ConcurrentPoolArena::local_cache() noexcept {
+	ThreadState& state = thread_state();
+	if (state.last_id == id) {
+		return state.last_cache;
+	}
+	if (state.exited) {
+		return nullptr;
+	}
+
+	ThreadCache* found = nullptr;
+	for (std::shared_ptr<ThreadCache>& cache : thread_caches().caches) {
+		if (cache->owner_id == id) {
+			found = cache.get();
+			break;
+		}
+	}
+	if (found == nullptr) {
+		try {
+			found = register_thread();
+		}
+		catch (...) {
+			return nullptr;
+		}
+	}
+	state.last_id = id;
+	state.last_cache = found;
+	return found;
+}
+
+//creates the cache of the calling thread, dropping caches of arenas that are gone
+inline ConcurrentPoolArena::ThreadCache* ConcurrentPoolArena::register_thread() {
+	std::shared_ptr<ThreadCache> cache = std::make_shared<ThreadCache>();
+	cache->owner = this;
+	cache->owner_id = id;
+	for (std::size_t i = 0; i < PoolArena::size_class_count; i++) {
+		cache->magazines[i].count = 0;
+	}
+
+	std::vector<std::shared_ptr<ThreadCache>>& local = thread_caches().caches;
+	for (std::size_t i = 0; i < local.size(); ) {
+		std::unique_lock<std::mutex> lock(local[i]->owner_mutex);
+		if (local[i]->owner == nullptr) {
+			lock.unlock();
+			local[i] = std::move(local.back());
+			local.pop_back();
+		}
+		else {
+			i++;
+		}
+	}
+	local.reserve(local.size() + 1);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	caches.push_back(cache);
+	local.push_back(cache);
+	return cache.get();
+}
+
+//takes half a magazine of blocks from the central pool
+inline void ConcurrentPoolArena::refill(Magazine& magazine, std::size_t index) {
+	std::size_t size = PoolArena::block_size(index);
+	std::size_t batch = magazine_capacity(index) / 2;
+	std::lock_guard<std::mutex> lock(mutex);
+	try {
+		while (magazine.count < batch) {
+			void* block = central.allocate(size);
+			magazine.blocks[magazine.count++] = block;
+		}
+	}
+	catch (...) {
+		if (magazine.count == 0) {
+			throw;
+		}
+	}
+}
+
+//returns the top count blocks of a magazine to the central pool
+inline void ConcurrentPoolArena::flush(Magazine& magazine, std::size_t index, std::size_t count) noexcept {
+	std::size_t size = PoolArena::block_size(index);
+	std::lock_guard<std::mutex> lock(mutex);
+	for (std::size_t i = 0; i < count; i++) {
+		central.deallocate(magazine.blocks[--magazine.count], size);
+	}
+}
+
+//gives back everything an exiting thread holds, expects cache.owner_mutex to be locked
+inline void ConcurrentPoolArena::release(ThreadCache& cache) noexcept {
+	for (std::size_t i = 0; i < PoolArena::size_class_count; i++) {
+		flush(cache.magazines[i], i, cache.magazines[i].count);
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	for (std::size_t i = 0; i < caches.size(); i++) {
+		if (caches[i].get() == &cache) {
+			caches[i] = std::move(caches.back());
+			caches.pop_back();
+			break;
+		}
+	}
+}
+
+inline ConcurrentPoolArena::ThreadCaches::~ThreadCaches() {
+	ThreadState& state = thread_state();
+	state.exited = true;
+	state.last_id = 0;
+	state.last_cache = nullptr;
+	for (std::shared_ptr<ThreadCache>& cache : caches) {
+		std::lock_guard<std::mutex> lock(cache->owner_mutex);
+		if (cache->owner != nullptr) {
+			cache->owner->release(*cache);
+			cache->owner = nullptr;
+		}
+	}
+}
+
+//ids are never reused, so a thread can not mistake a new arena for a destroyed one
+inline std::uint64_t ConcurrentPoolArena::next_id() noexcept {
+	static std::atomic<std::uint64_t> counter(0);
+	return ++counter;
+}
+
+inline ConcurrentPoolArena::ThreadCaches& ConcurrentPoolArena::thread_caches() {
+	thread_local ThreadCaches caches;
+	return caches;
+}
+
+inline ConcurrentPoolArena::ThreadState& ConcurrentPoolArena::thread_state() noexcept {
+	thread_local ThreadState state = { 0, nullptr, false };
+	return state;
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <limits>
+
+//Growth policies decide which capacity Vector reallocates to when it needs
+//room for `needed` elements of `element_size` bytes. All of them are stateless
+//and work on integers only.
+
+//capacity * 1.5, the classic Vector behaviour
+struct OneAndHalfGrowth {
+	static std::size_t next_capacity(std::size_t needed, std::size_t /*element_size*/) noexcept {
+		if (needed > std::numeric_limits<std::size_t>::max() - needed / 2) {
+			return needed;
+		}
+		return needed + needed / 2;
+	}
+};
+
+//capacity * 1.6, just under the golden ratio (1.618): with a factor below phi
+//the blocks freed by earlier growths can eventually be reused by the allocator
+struct GoldenRatioGrowth {
+	static std::size_t next_capacity(std::size_t needed, std::size_t /*element_size*/) noexcept {
+		if (needed > std::numeric_limits<std::size_t>::max() / 3) {
+			return needed;
+		}
+		return needed + (needed * 3) / 5;
+	}
+};
+
+//capacity * 2, fewest reallocations
+struct DoublingGrowth {
+	static std::size_t next_capacity(std::size_t needed, std::size_t /*element_size*/) noexcept {
+		if (needed > std::numeric_limits<std::size_t>::max() / 2) {
+			return needed;
+		}
+		return needed * 2;
+	}
+};
+
+//smallest power of two not less than needed, keeps allocation sizes in
+//the same size classes as most allocators use
+struct PowerOfTwoGrowth {
+	static std::size_t next_capacity(std::size_t needed, std::size_t /*element_size*/) noexcept {
+		std::size_t capacity = 1;
+		while (capacity < needed) {
+			if (capacity > std::numeric_limits<std::size_t>::max() / 2) {
+				return needed;
+			}
+			capacity *= 2;
+		}
+		return capacity;
+	}
+};
+
+//grows like Base, but once the buffer is at least Threshold bytes rounds
+//it up to whole pages so that no page is left partially used
+template <std::size_t PageSize = 4096, std::size_t Threshold = 16 * PageSize, class Base = OneAndHalfGrowth>
+struct PageGrowth {
+	static_assert(PageSize != 0 && (PageSize & (PageSize - 1)) == 0, "page size must be a power of two");
+
+	static std::size_t next_capacity(std::size_t needed, std::size_t element_size) noexcept {
+		std::size_t capacity = Base::next_capacity(needed, element_size);
+		if (element_size == 0 || capacity > std::numeric_limits<std::size_t>::max() / element_size - PageSize) {
+			return capacity;
+		}
+		std::size_t bytes = capacity * element_size;
+		if (bytes < Threshold) {
+			return capacity;
+		}
+		bytes = (bytes + PageSize - 1) & ~(PageSize - 1);
+		return bytes / element_size;
+	}
+};
+
+//rounds up to the next multiple of Increment elements, so unused capacity is
+//bounded by Increment elements at the cost of more reallocations
+template <std::size_t Increment>
+struct FixedIncrementGrowth {
+	static_assert(Increment > 0, "increment must be positive");
+
+	static std::size_t next_capacity(std::size_t needed, std::size_t /*element_size*/) noexcept {
+		if (needed == 0 || needed > std::numeric_limits<std::size_t>::max() - Increment) {
+			return needed;
+		}
+		return needed + Increment - 1 - (needed - 1) % Increment;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+//Fixed buffer of N bytes that usually lives on the caller's stack, in the
+//style of Howard Hinnant's short_alloc. Blocks are bumped off the buffer and
+//given back in LIFO order: freeing the block handed out last, or growing it,
+//moves the cursor. Requests that do not fit go to operator new, aligned to
+//block_alignment; deallocate must get the same block_alignment as allocate.
+template <std::size_t N, std::size_t Alignment = alignof(std::max_align_t)>
+class InlineArena {
+public:
+	static_assert(Alignment > 0 && (Alignment & (Alignment - 1)) == 0, "alignment must be a power of two");
+
+	static constexpr std::size_t size = N;
+	static constexpr std::size_t alignment = Alignment;
+
+	InlineArena() noexcept;
+	InlineArena(const InlineArena&) = delete;
+	InlineArena& operator=(const InlineArena&) = delete;
+
+	void* allocate(std::size_t bytes, std::size_t block_alignment = Alignment);
+	void deallocate(void* pointer, std::size_t bytes, std::size_t block_alignment = Alignment) noexcept;
+	bool try_expand(void* pointer, std::size_t old_bytes, std::size_t new_bytes) noexcept;
+
+	bool owns(const void* pointer) const noexcept;
+	std::size_t used() const noexcept;
+	//forgets every block in the buffer, heap blocks stay with their owners
+	void reset() noexcept;
+
+private:
+	alignas(Alignment) unsigned char buffer[N];
+	unsigned char* cursor;
+};
+
+//allocator over an InlineArena the caller keeps alive, e.g.
+//  InlineArena<1024> arena;
+//  Vector<int, ArenaAlloc<int, 1024>> numbers{ ArenaAlloc<int, 1024>(arena) };
+template <class T, std::size_t N, std::size_t Alignment = alignof(std::max_align_t)>
+class ArenaAlloc {
+public:
+	static_assert(alignof(T) <= Alignment, "the arena is not aligned enough for T");
+
+	using value_type = T;
+	using arena_type = InlineArena<N, Alignment>;
+	//the storage belongs to one arena, containers keep theirs like std::pmr does
+	using propagate_on_container_copy_assignment = std::false_type;
+	using propagate_on_container_move_assignment = std::false_type;
+	using propagate_on_container_swap = std::false_type;
+	using is_always_equal = std::false_type;
+
+	template <class U>
+	struct rebind {
+		using other = ArenaAlloc<U, N, Alignment>;
+	};
+
+	explicit ArenaAlloc(arena_type& arena) noexcept;
+	template <class U>
+	ArenaAlloc(const ArenaAlloc<U, N, Alignment>& other) noexcept;
+
+	T* allocate(std::size_t n);
+	void deallocate(T* pointer, std::size_t n) noexcept;
+	bool try_expand(T* pointer, std::size_t old_n, std::size_t new_n) noexcept;
+
+	arena_type& arena() const noexcept;
+
+	template <class U, class F, std::size_t M, std::size_t A>
+	friend bool operator==(const ArenaAlloc<U, M, A>& lhs, const ArenaAlloc<F, M, A>& rhs) noexcept;
+
+	template <class U, class F, std::size_t M, std::size_t A>
+	friend bool operator!=(const ArenaAlloc<U, M, A>& lhs, const ArenaAlloc<F, M, A>& rhs) noexcept;
+
+private:
+	template <class U, std::size_t M, std::size_t A>
+	friend class ArenaAlloc;
+
+	arena_type* _arena;
+};
+
+template <std::size_t N, std::size_t Alignment>
+InlineArena<N, Alignment>::InlineArena() noexcept
+	: cursor(buffer) {}
+
+template <std::size_t N, std::size_t Alignment>
+void* InlineArena<N, Alignment>::allocate(std::size_t bytes, std::size_t block_alignment) {
+	std::size_t offset = cursor - buffer;
+	std::size_t padding = (block_alignment - offset % block_alignment) % block_alignment;
+	if (block_alignment <= Alignment && padding <= N - offset && bytes <= N - offset - padding) {
+		unsigned char* block = cursor + padding;
+		cursor = block + bytes;
+		return block;
+	}
+	if (block_alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+		return ::operator new(bytes, std::align_val_t(block_alignment));
+	}
+	return ::operator new(bytes);
+}
+
+template <std::size_t N, std::size_t Alignment>
+void InlineArena<N, Alignment>::deallocate(void* pointer, std::size_t bytes, std::size_t block_alignment) noexcept {
+	if (!owns(pointer)) {
+		if (block_alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+			::operator delete(pointer, std::align_val_t(block_alignment));
+			return;
+		}
+		::operator delete(pointer);
+		return;
+	}
+	if (static_cast<unsigned char*>(pointer) + bytes == cursor) {
+		cursor = static_cast<unsigned char*>(pointer);
+	}
+}
+
+//only the block handed out last can grow
+template <std::size_t N, std::size_t Alignment>
+bool InlineArena<N, Alignment>::try_expand(void* pointer, std::size_t old_bytes, std::size_t new_bytes) noexcept {
+	unsigned char* block = static_cast<unsigned char*>(pointer);
+	if (!owns(pointer) || block + old_bytes != cursor) {
+		return false;
+	}
+	if (new_bytes > static_cast<std::size_t>(buffer + N - block)) {
+		return false;
+	}
+	cursor = block + new_bytes;
+	return true;
+}
+
+template <std::size_t N, std::size_t Alignment>
+bool InlineArena<N, Alignment>::owns(const void* pointer) const noexcept {
+	std::uintptr_t address = reinterpret_cast<std::uintptr_t>(pointer);
+	std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(buffer);
+	return address >= begin && address < begin + N;
+}
+
+template <std::size_t N, std::size_t Alignment>
+std::size_t InlineArena<N, Alignment>::used() const noexcept {
+	return cursor - buffer;
+}
+
+template <std::size_t N, std::size_t Alignment>
+void InlineArena<N, Alignment>::reset() noexcept {
+	cursor = buffer;
+}
+
+template <class T, std::size_t N, std::size_t Alignment>
+ArenaAlloc<T, N, Alignment>::ArenaAlloc(arena_type& arena) noexcept
+	: _arena(&arena) {}
+
+template <class T, std::size_t N, std::size_t Alignment>
+template <class U>
+ArenaAlloc<T, N, Alignment>::ArenaAlloc(const ArenaAlloc<U, N, Alignment>& other) noexcept
+	: _arena(other._arena) {}
+
+template <class T, std::size_t N, std::size_t Alignment>
+T* ArenaAlloc<T, N, Alignment>::allocate(std::size_t n) {
+	if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+		throw std::bad_alloc();
+	}
+	return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+}
+
+template <class T, std::size_t N, std::size_t Alignment>
+void ArenaAlloc<T, N, Alignment>::deallocate(T* pointer, std::size_t n) noexcept {
+	_arena->deallocate(pointer, n * sizeof(T), alignof(T));
+}
+
+template <class T, std::size_t N, std::size_t Alignment>
+bool ArenaAlloc<T, N, Alignment>::try_expand(T* pointer, std::size_t old_n, std::size_t new_n) noexcept {
+	if (new_n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+		return false;
+	}
+	return _arena->try_expand(pointer, old_n * sizeof(T), new_n * sizeof(T));
+}
+
+template <class T, std::size_t N, std::size_t Alignment>
+typename ArenaAlloc<T, N, Alignment>::arena_type& ArenaAlloc<T, N, Alignment>::arena() const noexcept {
+	return *_arena;
+}
+
+template <class U, class F, std::size_t M, std::size_t A>
+bool operator==(const ArenaAlloc<U, M, A>& lhs, const ArenaAlloc<F, M, A>& rhs) noexcept {
+	return lhs._arena == rhs._arena;
+}
+
+template <class U, class F, std::size_t M, std::size_t A>
+bool operator!=(const ArenaAlloc<U, M, A>& lhs, const ArenaAlloc<F, M, A>& rhs) noexcept {
+	return !(lhs == rhs);
+}
\ No newline at end of file
@@ -4,232 +4,236 @@
 #include <algorithm>
 #include <stdexcept>
 #include <iostream>
-#include <ctgmath>
+#include <iterator>
+#include <type_traits>
 
+//Contiguous iterator over Vector storage: a thin wrapper around a single
+//element pointer, so standard algorithms can treat it as a raw pointer
 template <class T, bool is_const>
 class VectorIterator
 {
 public:
 	using size_type = std::size_t;
 	using difference_type = std::ptrdiff_t;
-	using value_type = typename std::conditional<is_const, const T, T>::type;
+	using value_type = typename std::remove_cv<T>::type;
+	using element_type = typename std::conditional<is_const, const T, T>::type;
 	using reference = typename std::conditional<is_const, const T&, T&>::type;
 	using pointer = typename std::conditional<is_const, const T*, T*>::type;
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+	using iterator_category = std::contiguous_iterator_tag;
+	using iterator_concept = std::contiguous_iterator_tag;
+#else
 	using iterator_category = std::random_access_iterator_tag;
+#endif
 
-	VectorIterator() = delete;
-	explicit VectorIterator(pointer struct_pointer, difference_type pos = 0);
-	VectorIterator(const VectorIterator& other);
+	VectorIterator() noexcept;
+	explicit VectorIterator(pointer element_pointer) noexcept;
+	VectorIterator(const VectorIterator& other) noexcept;
 
-	operator VectorIterator<T, true>() const;
+	operator VectorIterator<T, true>() const noexcept;
 
-	VectorIterator& operator=(const VectorIterator& rhs);
+	VectorIterator& operator=(const VectorIterator& rhs) noexcept;
 
-	VectorIterator& operator++(); 
-	const VectorIterator operator++(int);
+	VectorIterator& operator++() noexcept;
+	VectorIterator operator++(int) noexcept;
 
-	VectorIterator& operator--(); 
-	const VectorIterator operator--(int); 
+	VectorIterator& operator--() noexcept;
+	VectorIterator operator--(int) noexcept;
 
-	reference operator*() const;
-	pointer operator->();
+	reference operator*() const noexcept;
+	pointer operator->() const noexcept;
 
 	template <class U, bool is_const_u, class F, bool is_const_f>
-	friend bool operator==(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs);
+	friend bool operator==(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs) noexcept;
 
 	template <class U, bool is_const_u, class F, bool is_const_f>
-	friend bool operator!=(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs);
+	friend bool operator!=(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs) noexcept;
 
-	VectorIterator& operator+=(size_type);
+	VectorIterator& operator+=(difference_type) noexcept;
 
 	template<class U, bool is_const_u>
 	friend VectorIterator<U, is_const_u> operator+(const VectorIterator<U, is_const_u>& lhs,
-		typename VectorIterator<U, is_const_u>::size_type);
+		typename VectorIterator<U, is_const_u>::difference_type) noexcept;
 
 	template<class U, bool is_const_u>
-	friend VectorIterator<U, is_const_u> operator+(typename VectorIterator<U, is_const_u>::size_type,
-		const VectorIterator<U, is_const_u>& rhs);
+	friend VectorIterator<U, is_const_u> operator+(typename VectorIterator<U, is_const_u>::difference_type,
+		const VectorIterator<U, is_const_u>& rhs) noexcept;
 
-	VectorIterator& operator-=(size_type);
+	VectorIterator& operator-=(difference_type) noexcept;
 
 	template<class U, bool is_const_u>
 	friend VectorIterator<U, is_const_u> operator-(const VectorIterator<U, is_const_u>& lhs,
-		typename VectorIterator<U, is_const_u>::size_type);
+		typename VectorIterator<U, is_const_u>::difference_type) noexcept;
 
 	template <class U, bool is_const_u, class F, bool is_const_f>
-	friend typename VectorIterator<U, is_const_u>::difference_type operator-(VectorIterator<U, is_const_u>& lhs,
-		VectorIterator<F, is_const_f>& rhs);
+	friend typename VectorIterator<U, is_const_u>::difference_type operator-(const VectorIterator<U, is_const_u>& lhs,
+		const VectorIterator<F, is_const_f>& rhs) noexcept;
 
-	reference operator[](size_type) const;
+	reference operator[](difference_type) const noexcept;
 
 	template <class U, bool is_const_u, class F, bool is_const_f>
-	friend bool operator<(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs);
+	friend bool operator<(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs) noexcept;
 
 	template <class U, bool is_const_u, class F, bool is_const_f>
-	friend bool operator>(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs);
+	friend bool operator>(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs) noexcept;
 
 	template <class U, bool is_const_u, class F, bool is_const_f>
-	friend bool operator<=(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs);
+	friend bool operator<=(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs) noexcept;
 
 	template <class U, bool is_const_u, class F, bool is_const_f>
-	friend bool operator>=(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs);
-
-	difference_type pos() const;
+	friend bool operator>=(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs) noexcept;
 
 private:
-	pointer _struct_pointer;
-	difference_type _pos;
+	pointer _element_pointer;
 };
 
 template<class T, bool is_const>
-typename VectorIterator<T, is_const>::difference_type VectorIterator<T, is_const>::pos() const{
-	return _pos;
-}
+VectorIterator<T, is_const>::VectorIterator() noexcept
+	: _element_pointer(nullptr) {}
 
 template<class T, bool is_const>
-VectorIterator<T, is_const>::VectorIterator(pointer struct_pointer, difference_type pos)
-	: _struct_pointer(struct_pointer), _pos(pos) {}
+VectorIterator<T, is_const>::VectorIterator(pointer element_pointer) noexcept
+	: _element_pointer(element_pointer) {}
 
 template<class T, bool is_const>
-VectorIterator<T, is_const>::VectorIterator(const VectorIterator& other)
-: VectorIterator(other._struct_pointer, other._pos) {}
+VectorIterator<T, is_const>::VectorIterator(const VectorIterator& other) noexcept
+	: VectorIterator(other._element_pointer) {}
 
 template<class T, bool is_const>
-VectorIterator<T, is_const>::operator VectorIterator<T, true>() const
+VectorIterator<T, is_const>::operator VectorIterator<T, true>() const noexcept
 {
-	return VectorIterator<T, true>(_struct_pointer, _pos);
+	return VectorIterator<T, true>(_element_pointer);
 }
 
 template<class T, bool is_const>
-VectorIterator<T, is_const>& VectorIterator<T, is_const>::operator=(const VectorIterator& other)
+VectorIterator<T, is_const>& VectorIterator<T, is_const>::operator=(const VectorIterator& other) noexcept
 {
-	if (this != &other) {
-		_struct_pointer = other._struct_pointer;
-		_pos = other._pos;
-	}
-
+	_element_pointer = other._element_pointer;
 	return *this;
 }
 
 template<class T, bool is_const>
-VectorIterator<T, is_const>& VectorIterator<T, is_const>::operator++()
+VectorIterator<T, is_const>& VectorIterator<T, is_const>::operator++() noexcept
 {
-	_pos++;
+	++_element_pointer;
 	return *this;
 }
 
 template<class T, bool is_const>
-const VectorIterator<T, is_const> VectorIterator<T, is_const>::operator++(int)
+VectorIterator<T, is_const> VectorIterator<T, is_const>::operator++(int) noexcept
 {
-	VectorIterator<T, is_const> tmp(*this); 
+	VectorIterator<T, is_const> tmp(*this);
 	operator++();
 	return tmp;
 }
 
 template<class T, bool is_const>
-VectorIterator<T, is_const>& VectorIterator<T, is_const>::operator--()
+VectorIterator<T, is_const>& VectorIterator<T, is_const>::operator--() noexcept
 {
-	_pos--;
+	--_element_pointer;
 	return *this;
 }
 
 template<class T, bool is_const>
-const VectorIterator<T, is_const> VectorIterator<T, is_const>::operator--(int)
+VectorIterator<T, is_const> VectorIterator<T, is_const>::operator--(int) noexcept
 {
-	VectorIterator<T, is_const> tmp(*this); 
+	VectorIterator<T, is_const> tmp(*this);
 	operator--();
 	return tmp;
 }
 
 template<class T, bool is_const>
-typename VectorIterator<T, is_const>::reference VectorIterator<T, is_const>::operator*() const
+typename VectorIterator<T, is_const>::reference VectorIterator<T, is_const>::operator*() const noexcept
 {
-	return *(_struct_pointer + _pos);
+	return *_element_pointer;
 }
 
 template<class T, bool is_const>
-typename VectorIterator<T, is_const>::pointer VectorIterator<T, is_const>::operator->()
+typename VectorIterator<T, is_const>::pointer VectorIterator<T, is_const>::operator->() const noexcept
 {
-	return _struct_pointer + _pos;
+	return _element_pointer;
 }
 
 template<class U, bool is_const_u, class F, bool is_const_f>
-bool operator==(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs)
+bool operator==(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs) noexcept
 {
-	return lhs._pos == rhs._pos;
+	return lhs._element_pointer == rhs._element_pointer;
 }
 
 template<class U, bool is_const_u, class F, bool is_const_f>
-bool operator!=(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs)
+bool operator!=(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs) noexcept
 {
-	return lhs._pos != rhs._pos;
+	return lhs._element_pointer != rhs._element_pointer;
 }
 
 template<class U, bool is_const_u>
 VectorIterator<U, is_const_u> operator+(const VectorIterator<U, is_const_u>& lhs,
-	typename VectorIterator<U, is_const_u>::size_type rhs)
+	typename VectorIterator<U, is_const_u>::difference_type rhs) noexcept
 {
-	return VectorIterator<U, is_const_u>(lhs._struct_pointer, lhs._pos + rhs);
+	return VectorIterator<U, is_const_u>(lhs._element_pointer + rhs);
 }
 
 template<class U, bool is_const_u>
-VectorIterator<U, is_const_u> operator+(typename VectorIterator<U, is_const_u>::size_type lhs, const VectorIterator<U, is_const_u>& rhs)
+VectorIterator<U, is_const_u> operator+(typename VectorIterator<U, is_const_u>::difference_type lhs,
+	const VectorIterator<U, is_const_u>& rhs) noexcept
 {
 	return rhs + lhs;
 }
 
 template<class T, bool is_const>
-VectorIterator<T, is_const>& VectorIterator<T, is_const>::operator+=(VectorIterator::size_type n)
+VectorIterator<T, is_const>& VectorIterator<T, is_const>::operator+=(VectorIterator::difference_type n) noexcept
 {
-	_pos += n;
+	_element_pointer += n;
 	return *this;
 }
 
 template<class T, bool is_const>
-VectorIterator<T, is_const>& VectorIterator<T, is_const>::operator-=(VectorIterator::size_type n)
+VectorIterator<T, is_const>& VectorIterator<T, is_const>::operator-=(VectorIterator::difference_type n) noexcept
 {
-	_pos -= n;
+	_element_pointer -= n;
 	return *this;
 }
 
 template<class U, bool is_const_u>
-VectorIterator<U, is_const_u> operator-(const VectorIterator<U, is_const_u>& lhs, typename VectorIterator<U, is_const_u>::size_type rhs)
+VectorIterator<U, is_const_u> operator-(const VectorIterator<U, is_const_u>& lhs,
+	typename VectorIterator<U, is_const_u>::difference_type rhs) noexcept
 {
-	return VectorIterator<U, is_const_u>(lhs._struct_pointer, lhs._pos - rhs);
+	return VectorIterator<U, is_const_u>(lhs._element_pointer - rhs);
 }
 
 template<class U, bool is_const_u, class F, bool is_const_f>
-typename VectorIterator<U, is_const_u>::difference_type operator-(VectorIterator<U, is_const_u>& lhs, VectorIterator<F, is_const_f>& rhs)
+typename VectorIterator<U, is_const_u>::difference_type operator-(const VectorIterator<U, is_const_u>& lhs,
+	const VectorIterator<F, is_const_f>& rhs) noexcept
 {
-	return lhs._pos - rhs._pos;
+	return lhs._element_pointer - rhs._element_pointer;
 }
 
 template<class T, bool is_const>
-typename VectorIterator<T, is_const>::reference VectorIterator<T, is_const>::operator[](VectorIterator::size_type n) const
+typename VectorIterator<T, is_const>::reference VectorIterator<T, is_const>::operator[](VectorIterator::difference_type n) const noexcept
 {
-	return *(_struct_pointer + _pos + n);
+	return _element_pointer[n];
 }
 
 template<class U, bool is_const_u, class F, bool is_const_f>
-bool operator<(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs)
+bool operator<(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs) noexcept
 {
-	return lhs._pos < rhs._pos;
+	return lhs._element_pointer < rhs._element_pointer;
 }
 
 template<class U, bool is_const_u, class F, bool is_const_f>
-bool operator>(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs)
+bool operator>(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs) noexcept
 {
-	return lhs._pos > rhs._pos;
+	return lhs._element_pointer > rhs._element_pointer;
 }
 
 template<class U, bool is_const_u, class F, bool is_const_f>
-bool operator<=(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs)
+bool operator<=(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs) noexcept
 {
-	return lhs._pos <= rhs._pos;
+	return lhs._element_pointer <= rhs._element_pointer;
 }
 
 template<class U, bool is_const_u, class F, bool is_const_f>
-bool operator>=(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs)
+bool operator>=(const VectorIterator<U, is_const_u>& lhs, const VectorIterator<F, is_const_f>& rhs) noexcept
 {
-	return lhs._pos >= rhs._pos;
+	return lhs._element_pointer >= rhs._element_pointer;
 }
\ No newline at end of file
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <cassert>
+#include <mutex>
+#include <new>
+#include "PoolArena.h"
+
+//Pool arena that many threads allocate from without taking a lock.
+//Every size class keeps its free blocks on a Treiber stack whose head packs
+//the top block pointer together with a version tag, so a pop that raced with
+//a pop and a push of the same block fails its compare-exchange instead of
+//installing a stale next pointer (the ABA problem).
+//Only an empty class takes a lock: it carves a whole run of new blocks out of
+//a central PoolArena and pushes them onto its stack in one step.
+//Chunks are released with the arena only, so reading the next pointer of a
+//block another thread has just taken never touches unmapped memory.
+//The FreeBlock of a block is constructed once, when its run is carved; later
+//pushes only store to its next pointer, which a racing pop may be loading.
+class LockFreePoolArena {
+public:
+	static constexpr std::size_t cache_line_size = 64;
+	static constexpr std::size_t alignment = PoolArena::alignment;
+
+	using stats_type = PoolArena::stats_type;
+
+	explicit LockFreePoolArena(unsigned backing = ChunkBacking::heap);
+	LockFreePoolArena(const LockFreePoolArena&) = delete;
+	LockFreePoolArena& operator=(const LockFreePoolArena&) = delete;
+
+	void* allocate(std::size_t bytes);
+	void deallocate(void* pointer, std::size_t bytes) noexcept;
+	void allocate_bulk(std::size_t bytes, std::size_t count, void** blocks);
+	//pushes the whole batch with a single compare-exchange
+	void deallocate_bulk(std::size_t bytes, std::size_t count, void* const* blocks) noexcept;
+	bool try_expand(void* pointer, std::size_t old_bytes, std::size_t new_bytes) noexcept;
+
+	std::size_t reserved_bytes() const;
+	//statistics of the central pool, which only sees whole runs:
+	//every carved run counts as one block in use
+	stats_type stats() const;
+
+private:
+	struct FreeBlock {
+		std::atomic<FreeBlock*> next;
+	};
+
+	//head of a Treiber stack: pointer in the low pointer_bits, version tag above them.
+	//User space addresses fit in 48 bits on the 64-bit targets we build for,
+	//pack asserts it for every block pushed.
+	class FreeStack {
+	public:
+		FreeStack() noexcept;
+
+		void push(FreeBlock* first, FreeBlock* last) noexcept;
+		FreeBlock* pop() noexcept;
+
+	private:
+		static constexpr unsigned pointer_bits = sizeof(void*) == 8 ? 48 : 32;
+		static constexpr std::uint64_t pointer_mask = (std::uint64_t(1) << pointer_bits) - 1;
+
+		static std::uint64_t pack(FreeBlock* block, std::uint64_t tag) noexcept;
+		static FreeBlock* block_of(std::uint64_t head) noexcept;
+		static std::uint64_t next_tag(std::uint64_t head) noexcept;
+
+		std::atomic<std::uint64_t> head;
+	};
+
+	static_assert(sizeof(void*) <= 8, "the tagged head needs the spare upper bits of a 64-bit word");
+	static_assert(PoolArena::min_block_size >= sizeof(FreeBlock), "a free block must fit the free list link");
+
+	//each stack on its own cache line, so threads hammering neighbouring
+	//classes do not invalidate each other
+	struct alignas(cache_line_size) SizeClass {
+		FreeStack free_list;
+	};
+
+	void refill(std::size_t index);
+
+	SizeClass classes[PoolArena::size_class_count];
+	mutable std::mutex central_mutex;
+	PoolArena central;
+};
+
+inline LockFreePoolArena::LockFreePoolArena(unsigned backing)
+	: central(backing) {}
+
+inline void* LockFreePoolArena::allocate(std::size_t bytes) {
+	if (bytes > PoolArena::max_block_size) {
+		return ::operator new(bytes);
+	}
+
+	std::size_t index = PoolArena::size_class(bytes);
+	FreeStack& free_list = classes[index].free_list;
+	FreeBlock* block = free_list.pop();
+	while (block == nullptr) {
+		refill(index);
+		block = free_list.pop();
+	}
+	return block;
+}
+
+inline void LockFreePoolArena::deallocate(void* pointer, std::size_t bytes) noexcept {
+	if (pointer == nullptr) {
+		return;
+	}
+	if (bytes > PoolArena::max_block_size) {
+		::operator delete(pointer);
+		return;
+	}
+	FreeBlock* block = static_cast<FreeBlock*>(pointer);
+	classes[PoolArena::size_class(bytes)].free_list.push(block, block);
+}
+
+inline void LockFreePoolArena::allocate_bulk(std::size_t bytes, std::size_t count, void** blocks) {
+	std::size_t done = 0;
+	try {
+		for (; done < count; done++) {
+			blocks[done] = allocate(bytes);
+		}
+	}
+	catch (...) {
+		deallocate_bulk(bytes, done, blocks);
+		throw;
+	}
+}
+
+inline void LockFreePoolArena::deallocate_bulk(std::size_t bytes, std::size_t count, void* const* blocks) noexcept {
+	if (count == 0) {
+		return;
+	}
+	if (bytes > PoolArena::max_block_size) {
+		for (std::size_t i = 0; i < count; i++) {
+			::operator delete(blocks[i]);
+		}
+		return;
+	}
+	FreeBlock* first = static_cast<FreeBlock*>(blocks[0]);
+	FreeBlock* last = first;
+	for (std::size_t i = 1; i < count; i++) {
+		FreeBlock* block = static_cast<FreeBlock*>(blocks[i]);
+		last->next.store(block, std::memory_order_relaxed);
+		last = block;
+	}
+	classes[PoolArena::size_class(bytes)].free_list.push(first, last);
+}
+
+inline bool LockFreePoolArena::try_expand(void* pointer, std::size_t old_bytes, std::size_t new_bytes) noexcept {
+	return central.try_expand(pointer, old_bytes, new_bytes);
+}
+
+inline std::size_t LockFreePoolArena::reserved_bytes() const {
+	std::lock_guard<std::mutex> lock(central_mutex);
+	return central.reserved_bytes();
+}
+
+inline LockFreePoolArena::stats_type LockFreePoolArena::stats() const {
+	std::lock_guard<std::mutex> lock(central_mutex);
+	return central.stats();
+}
+
+//takes a run from the central arena, links its blocks and pushes the whole chain at once
+inline void LockFreePoolArena::refill(std::size_t index) {
+	std::size_t size = PoolArena::block_size(index);
+	char* run;
+	{
+		std::lock_guard<std::mutex> lock(central_mutex);
+		run = static_cast<char*>(central.allocate(PoolArena::run_size));
+	}
+	std::size_t count = PoolArena::run_size / size;
+	FreeBlock* first = new (run) FreeBlock();
+	FreeBlock* last = first;
+	for (std::size_t i = 1; i < count; i++) {
+		FreeBlock* block = new (run + i * size) FreeBlock();
+		last->next.store(block, std::memory_order_relaxed);
+		last = block;
+	}
+	classes[index].free_list.push(first, last);
+}
+
+inline LockFreePoolArena::FreeStack::FreeStack() noexcept
+	: head(0) {}
+
+//links first..last, already chained, in front of the current top
+inline void LockFreePoolArena::FreeStack::push(FreeBlock* first, FreeBlock* last) noexcept {
+	std::uint64_t current = head.load(std::memory_order_relaxed);
+	do {
+		last->next.store(block_of(current), std::memory_order_relaxed);
+	} while (!head.compare_exchange_weak(current, pack(first, next_tag(current)),
+		std::memory_order_release, std::memory_order_relaxed));
+}
+
+//the next pointer may be read from a block another thread already took,
+//the tag then no longer matches and the value read is discarded
+inline LockFreePoolArena::FreeBlock* LockFreePoolArena::FreeStack::pop() noexcept {
+	std::uint64_t current = head.load(std::memory_order_acquire);
+	while (true) {
+		FreeBlock* block = block_of(current);
+		if (block == nullptr) {
+			return nullptr;
+		}
+		FreeBlock* next = block->next.load(std::memory_order_relaxed);
+		if (head.compare_exchange_weak(current, pack(next, next_tag(current)),
+			std::memory_order_acquire, std::memory_order_acquire)) {
+			return block;
+		}
+	}
+}
+
+inline std::uint64_t LockFreePoolArena::FreeStack::pack(FreeBlock* block, std::uint64_t tag) noexcept {
+	assert((static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(block)) & ~pointer_mask) == 0
+		&& "block address does not fit the pointer bits of the tagged head");
+	return static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(block)) | (tag << pointer_bits);
+}
+
+inline LockFreePoolArena::FreeBlock* LockFreePoolArena::FreeStack::block_of(std::uint64_t head) noexcept {
+	return reinterpret_cast<FreeBlock*>(static_cast<std::uintptr_t>(head & pointer_mask));
+}
+
+//the tag wraps around within the bits above the pointer
+inline std::uint64_t LockFreePoolArena::FreeStack::next_tag(std::uint64_t head) noexcept {
+	return (head >> pointer_bits) + 1;
+}
\ No newline at end of file
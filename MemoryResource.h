@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include "vector.h"
+#include "Allocator.h"
+
+//std::pmr::memory_resource over a pool arena, so pmr containers and
+//polymorphic_allocator users can draw from the same pool as Allocator.
+//Pool blocks are aligned to their size up to Arena::alignment, so a request
+//is rounded up to its alignment to land in a class that honours it.
+//Stronger alignments go to aligned operator new.
+template <class Arena = PoolArena>
+class BasicPoolResource : public std::pmr::memory_resource {
+public:
+	BasicPoolResource();
+	explicit BasicPoolResource(std::shared_ptr<Arena> arena) noexcept;
+	template <class T>
+	explicit BasicPoolResource(const Allocator<T, Arena>& alloc) noexcept;
+
+	const std::shared_ptr<Arena>& shared_arena() const noexcept;
+
+protected:
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+	void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+	std::shared_ptr<Arena> arena;
+};
+
+using PoolResource = BasicPoolResource<PoolArena>;
+using ConcurrentPoolResource = BasicPoolResource<ConcurrentPoolArena>;
+
+namespace pmr {
+	//Vector over a std::pmr::polymorphic_allocator. Like std::pmr::vector the
+	//resource never propagates: copies use the default resource, and moves and
+	//swaps between different resources move the elements.
+	template <class T, class GrowthPolicy = OneAndHalfGrowth, class BoundsCheck = DefaultBoundsCheck>
+	using Vector = ::Vector<T, std::pmr::polymorphic_allocator<T>, GrowthPolicy, BoundsCheck>;
+}
+
+template <class Arena>
+BasicPoolResource<Arena>::BasicPoolResource()
+	: arena(std::make_shared<Arena>()) {}
+
+template <class Arena>
+BasicPoolResource<Arena>::BasicPoolResource(std::shared_ptr<Arena> arena) noexcept
+	: arena(std::move(arena)) {}
+
+//shares the pool of alloc, blocks can be freed through either of them
+template <class Arena>
+template <class T>
+BasicPoolResource<Arena>::BasicPoolResource(const Allocator<T, Arena>& alloc) noexcept
+	: arena(alloc.shared_arena()) {}
+
+template <class Arena>
+const std::shared_ptr<Arena>& BasicPoolResource<Arena>::shared_arena() const noexcept {
+	return arena;
+}
+
+template <class Arena>
+void* BasicPoolResource<Arena>::do_allocate(std::size_t bytes, std::size_t alignment) {
+	if (alignment > Arena::alignment) {
+		return ::operator new(bytes, std::align_val_t(alignment));
+	}
+	return arena->allocate(bytes < alignment ? alignment : bytes);
+}
+
+template <class Arena>
+void BasicPoolResource<Arena>::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) {
+	if (alignment > Arena::alignment) {
+		::operator delete(pointer, std::align_val_t(alignment));
+		return;
+	}
+	arena->deallocate(pointer, bytes < alignment ? alignment : bytes);
+}
+
+template <class Arena>
+bool BasicPoolResource<Arena>::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+	const BasicPoolResource* pool = dynamic_cast<const BasicPoolResource*>(&other);
+	return pool != nullptr && pool->arena == arena;
+}
\ No newline at end of file
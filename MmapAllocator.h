@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include "ChunkBacking.h"
+#include "vector.h"
+
+//Allocator for very large buffers. Blocks of Threshold bytes and more are
+//anonymous mappings of their own, smaller ones come from operator new.
+//A mapped block grows and shrinks with mremap where the system has it: in place
+//through try_expand, else by moving its page tables through reallocate, so a
+//Vector of trivially relocatable elements never copies them and never holds
+//the old and the new buffer at once. The pages a mapping grows by read as zeros,
+//so growing a value-initialized Vector does not touch them either.
+template <class T, std::size_t Threshold = 1048576>
+class MmapAllocator {
+public:
+	static constexpr std::size_t threshold = Threshold;
+
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	template <class U>
+	struct rebind {
+		using other = MmapAllocator<U, Threshold>;
+	};
+
+	MmapAllocator() noexcept = default;
+	template <class U>
+	MmapAllocator(const MmapAllocator<U, Threshold>&) noexcept;
+
+	T* allocate(std::size_t n);
+	//mapped blocks are fresh mappings, their pages read as zeros until first written
+	T* allocate_zeroed(std::size_t n);
+	void deallocate(T* pointer, std::size_t n) noexcept;
+	//both leave the elements past old_n zero, see allocate_zeroed in AllocatorHooks.h
+	bool try_expand(T* pointer, std::size_t old_n, std::size_t new_n) noexcept;
+	T* reallocate(T* pointer, std::size_t old_n, std::size_t new_n);
+
+	//blocks of n elements are mappings of their own
+	static bool is_mapped(std::size_t n) noexcept;
+
+	template <class U, class F, std::size_t M>
+	friend bool operator==(const MmapAllocator<U, M>&, const MmapAllocator<F, M>&) noexcept;
+
+	template <class U, class F, std::size_t M>
+	friend bool operator!=(const MmapAllocator<U, M>&, const MmapAllocator<F, M>&) noexcept;
+
+private:
+	static unsigned backing(std::size_t n) noexcept;
+	//blocks of n elements come from allocate already zero
+	static bool zero_filled(std::size_t n) noexcept;
+};
+
+//Vector whose buffer moves to its own mapping once it reaches Threshold bytes
+template <class T, std::size_t Threshold = 1048576, class GrowthPolicy = OneAndHalfGrowth, class BoundsCheck = DefaultBoundsCheck>
+using MmapVector = Vector<T, MmapAllocator<T, Threshold>, GrowthPolicy, BoundsCheck>;
+
+template <class T, std::size_t Threshold>
+template <class U>
+MmapAllocator<T, Threshold>::MmapAllocator(const MmapAllocator<U, Threshold>&) noexcept {}
+
+template <class T, std::size_t Threshold>
+T* MmapAllocator<T, Threshold>::allocate(std::size_t n) {
+	if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+		throw std::bad_alloc();
+	}
+	std::size_t bytes = n * sizeof(T);
+	unsigned block_backing = backing(n);
+	return static_cast<T*>(ChunkBacking::allocate(bytes, block_backing, alignof(T)));
+}
+
+template <class T, std::size_t Threshold>
+T* MmapAllocator<T, Threshold>::allocate_zeroed(std::size_t n) {
+	T* block = allocate(n);
+	if (!zero_filled(n)) {
+		std::memset(static_cast<void*>(block), 0, n * sizeof(T));
+	}
+	return block;
+}
+
+template <class T, std::size_t Threshold>
+void MmapAllocator<T, Threshold>::deallocate(T* pointer, std::size_t n) noexcept {
+	ChunkBacking::deallocate(pointer, n * sizeof(T), backing(n), alignof(T));
+}
+
+//heap blocks never grow, they would have to become mappings
+template <class T, std::size_t Threshold>
+bool MmapAllocator<T, Threshold>::try_expand(T* pointer, std::size_t old_n, std::size_t new_n) noexcept {
+	if (new_n > std::numeric_limits<std::size_t>::max() / sizeof(T) || !is_mapped(old_n) || !is_mapped(new_n)) {
+		return false;
+	}
+	return ChunkBacking::remap(pointer, old_n * sizeof(T), new_n * sizeof(T), false) != nullptr;
+}
+
+//blocks crossing the threshold, and every block where there is no mremap,
+//are copied to a new block
+template <class T, std::size_t Threshold>
+T* MmapAllocator<T, Threshold>::reallocate(T* pointer, std::size_t old_n, std::size_t new_n) {
+	if (new_n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+		throw std::bad_alloc();
+	}
+	if (is_mapped(old_n) && is_mapped(new_n)) {
+		void* moved = ChunkBacking::remap(pointer, old_n * sizeof(T), new_n * sizeof(T), true);
+		if (moved != nullptr) {
+			return static_cast<T*>(moved);
+		}
+	}
+	T* block = allocate(new_n);
+	std::memcpy(static_cast<void*>(block), static_cast<const void*>(pointer), std::min(old_n, new_n) * sizeof(T));
+	if (new_n > old_n && !zero_filled(new_n)) {
+		std::memset(static_cast<void*>(block + old_n), 0, (new_n - old_n) * sizeof(T));
+	}
+	deallocate(pointer, old_n);
+	return block;
+}
+
+template <class T, std::size_t Threshold>
+bool MmapAllocator<T, Threshold>::is_mapped(std::size_t n) noexcept {
+	return n >= (Threshold + sizeof(T) - 1) / sizeof(T);
+}
+
+template <class T, std::size_t Threshold>
+unsigned MmapAllocator<T, Threshold>::backing(std::size_t n) noexcept {
+	return is_mapped(n) ? ChunkBacking::mapped : ChunkBacking::heap;
+}
+
+//without mmap, mappings come from operator new
+template <class T, std::size_t Threshold>
+bool MmapAllocator<T, Threshold>::zero_filled(std::size_t n) noexcept {
+#if defined(_WIN32) || defined(__unix__) || defined(__APPLE__)
+	return is_mapped(n);
+#else
+	static_cast<void>(n);
+	return false;
+#endif
+}
+
+//blocks are told apart by their size alone, any instance frees any other's
+template <class U, class F, std::size_t M>
+bool operator==(const MmapAllocator<U, M>&, const MmapAllocator<F, M>&) noexcept {
+	return true;
+}
+
+template <class U, class F, std::size_t M>
+bool operator!=(const MmapAllocator<U, M>&, const MmapAllocator<F, M>&) noexcept {
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include "ChunkBacking.h"
+
+//Bump allocator for memory that dies all at once, e.g. the temporary
+//Vectors of one request. Blocks are carved from chunks that double in size,
+//deallocate does nothing and release() drops everything in one go.
+//The block handed out last can still grow in place while its chunk has room,
+//which Vector uses through the try_expand hook.
+class MonotonicArena {
+public:
+	static constexpr std::size_t initial_chunk_size = 65536;
+	static constexpr std::size_t max_chunk_size = 16777216;
+
+	explicit MonotonicArena(unsigned backing = ChunkBacking::heap);
+	MonotonicArena(const MonotonicArena&) = delete;
+	MonotonicArena& operator=(const MonotonicArena&) = delete;
+	~MonotonicArena();
+
+	void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+	void deallocate(void* pointer, std::size_t bytes) noexcept;
+	bool try_expand(void* pointer, std::size_t old_bytes, std::size_t new_bytes) noexcept;
+
+	//frees every block at once; the largest chunk is kept for the next round
+	void release() noexcept;
+
+	std::size_t reserved_bytes() const noexcept;
+	std::size_t used_bytes() const noexcept;
+
+private:
+	//header at the start of every chunk, keeps the chunks in a list
+	struct alignas(std::max_align_t) Chunk {
+		Chunk* next;
+		std::size_t size;
+	};
+
+	void add_chunk(std::size_t bytes, std::size_t alignment);
+	char* chunk_begin(Chunk* chunk) const noexcept;
+
+	Chunk* chunks;
+	char* cursor;
+	char* chunk_end;
+	char* last_block;
+	std::size_t next_chunk_size;
+	std::size_t reserved;
+	std::size_t used_in_full_chunks;
+	unsigned chunk_backing;
+};
+
+//allocator over a MonotonicArena the caller owns and keeps alive
+template <class T>
+class MonotonicAllocator {
+public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	using is_always_equal = std::false_type;
+
+	explicit MonotonicAllocator(MonotonicArena& arena) noexcept;
+	template <class U>
+	MonotonicAllocator(const MonotonicAllocator<U>& other) noexcept;
+
+	T* allocate(std::size_t n);
+	void deallocate(T* pointer, std::size_t n) noexcept;
+	bool try_expand(T* pointer, std::size_t old_n, std::size_t new_n) noexcept;
+
+	MonotonicArena& arena() const noexcept;
+
+	template <class U, class F>
+	friend bool operator==(const MonotonicAllocator<U>& lhs, const MonotonicAllocator<F>& rhs) noexcept;
+
+	template <class U, class F>
+	friend bool operator!=(const MonotonicAllocator<U>& lhs, const MonotonicAllocator<F>& rhs) noexcept;
+
+private:
+	template <class U>
+	friend class MonotonicAllocator;
+
+	MonotonicArena* _arena;
+};
+
+inline MonotonicArena::MonotonicArena(unsigned backing)
+	: chunks(nullptr), cursor(nullptr), chunk_end(nullptr), last_block(nullptr), next_chunk_size(initial_chunk_size),
+	reserved(0), used_in_full_chunks(0), chunk_backing(backing) {}
+
+inline MonotonicArena::~MonotonicArena() {
+	while (chunks != nullptr) {
+		Chunk* next = chunks->next;
+		ChunkBacking::deallocate(chunks, chunks->size, chunk_backing);
+		chunks = next;
+	}
+}
+
+inline void* MonotonicArena::allocate(std::size_t bytes, std::size_t alignment) {
+	std::uintptr_t address = reinterpret_cast<std::uintptr_t>(cursor);
+	std::size_t padding = (alignment - address % alignment) % alignment;
+	if (cursor == nullptr || static_cast<std::size_t>(chunk_end - cursor) < padding
+		|| static_cast<std::size_t>(chunk_end - cursor) - padding < bytes) {
+		add_chunk(bytes, alignment);
+		address = reinterpret_cast<std::uintptr_t>(cursor);
+		padding = (alignment - address % alignment) % alignment;
+	}
+	last_block = cursor + padding;
+	cursor = last_block + bytes;
+	return last_block;
+}
+
+//memory only comes back with release()
+inline void MonotonicArena::deallocate(void* /*pointer*/, std::size_t /*bytes*/) noexcept {}
+
+//only the last block can grow, and only while its chunk has room
+inline bool MonotonicArena::try_expand(void* pointer, std::size_t old_bytes, std::size_t new_bytes) noexcept {
+	if (pointer == nullptr || pointer != last_block || last_block + old_bytes != cursor) {
+		return false;
+	}
+	if (new_bytes > static_cast<std::size_t>(chunk_end - last_block)) {
+		return false;
+	}
+	cursor = last_block + new_bytes;
+	return true;
+}
+
+inline void MonotonicArena::release() noexcept {
+	if (chunks == nullptr) {
+		return;
+	}
+	//the newest chunk is the largest one
+	while (chunks->next != nullptr) {
+		Chunk* next = chunks->next;
+		chunks->next = next->next;
+		reserved -= next->size;
+		ChunkBacking::deallocate(next, next->size, chunk_backing);
+	}
+	cursor = chunk_begin(chunks);
+	last_block = nullptr;
+	used_in_full_chunks = 0;
+}
+
+inline std::size_t MonotonicArena::reserved_bytes() const noexcept {
+	return reserved;
+}
+
+//bytes handed out since the last release, alignment padding included
+inline std::size_t MonotonicArena::used_bytes() const noexcept {
+	if (chunks == nullptr) {
+		return 0;
+	}
+	return used_in_full_chunks + (cursor - chunk_begin(chunks));
+}
+
+//the rest of the current chunk is abandoned
+inline void MonotonicArena::add_chunk(std::size_t bytes, std::size_t alignment) {
+	if (bytes > std::numeric_limits<std::size_t>::max() - sizeof(Chunk) - alignment) {
+		throw std::bad_alloc();
+	}
+	std::size_t size = next_chunk_size;
+	while (size - sizeof(Chunk) < bytes + alignment) {
+		size *= 2;
+	}
+	Chunk* chunk = static_cast<Chunk*>(ChunkBacking::allocate(size, chunk_backing));
+	if (chunks != nullptr) {
+		used_in_full_chunks += cursor - chunk_begin(chunks);
+	}
+	chunk->next = chunks;
+	chunk->size = size;
+	chunks = chunk;
+	reserved += size;
+	cursor = chunk_begin(chunk);
+	chunk_end = reinterpret_cast<char*>(chunk) + size;
+	last_block = nullptr;
+	if (next_chunk_size < max_chunk_size) {
+		next_chunk_size *= 2;
+	}
+}
+
+inline char* MonotonicArena::chunk_begin(Chunk* chunk) const noexcept {
+	return reinterpret_cast<char*>(chunk + 1);
+}
+
+template <class T>
+MonotonicAllocator<T>::MonotonicAllocator(MonotonicArena& arena) noexcept
+	: _arena(&arena) {}
+
+template <class T>
+template <class U>
+MonotonicAllocator<T>::MonotonicAllocator(const MonotonicAllocator<U>& other) noexcept
+	: _arena(other._arena) {}
+
+template <class T>
+T* MonotonicAllocator<T>::allocate(std::size_t n) {
+	if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+		throw std::bad_alloc();
+	}
+	return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+}
+
+template <class T>
+void MonotonicAllocator<T>::deallocate(T* pointer, std::size_t n) noexcept {
+	_arena->deallocate(pointer, n * sizeof(T));
+}
+
+template <class T>
+bool MonotonicAllocator<T>::try_expand(T* pointer, std::size_t old_n, std::size_t new_n) noexcept {
+	if (new_n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+		return false;
+	}
+	return _arena->try_expand(pointer, old_n * sizeof(T), new_n * sizeof(T));
+}
+
+template <class T>
+MonotonicArena& MonotonicAllocator<T>::arena() const noexcept {
+	return *_arena;
+}
+
+template <class U, class F>
+bool operator==(const MonotonicAllocator<U>& lhs, const MonotonicAllocator<F>& rhs) noexcept {
+	return lhs._arena == rhs._arena;
+}
+
+template <class U, class F>
+bool operator!=(const MonotonicAllocator<U>& lhs, const MonotonicAllocator<F>& rhs) noexcept {
+	return !(lhs == rhs);
+}
\ No newline at end of file
@@ -0,0 +1,697 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include "ChunkBacking.h"
+#include "PoolStats.h"
+
+constexpr bool pool_is_power_of_two(std::size_t value) noexcept {
+	return value != 0 && (value & (value - 1)) == 0;
+}
+
+constexpr std::size_t pool_log2(std::size_t value) noexcept {
+	return value <= 1 ? 0 : 1 + pool_log2(value / 2);
+}
+
+//Geometry of a pool, checked at compile time by BasicPoolArena. Any struct
+//with the same static members can be given instead.
+//  InitialChunkSize, MaxChunkSize: the first chunk and the cap for later ones
+//  ChunkGrowth: factor between consecutive chunks, 1 keeps them all equal
+//  MinBlockSize, MaxBlockSize: smallest and largest size class, powers of two
+//  RunSize: bytes a size class takes out of a chunk at a time
+//  MaxReservedBytes: limit for all chunks together, 0 for none
+//  Alignment: alignment of chunks; blocks are aligned to their size up to it,
+//    so every block of at least Alignment bytes is aligned to Alignment
+template <std::size_t InitialChunkSize = 1048576, std::size_t MaxChunkSize = 67108864, std::size_t ChunkGrowth = 2,
+	std::size_t MinBlockSize = 8, std::size_t MaxBlockSize = 65536, std::size_t RunSize = 65536,
+	std::size_t MaxReservedBytes = 0, std::size_t Alignment = alignof(std::max_align_t)>
+struct PoolTraits {
+	static constexpr std::size_t initial_chunk_size = InitialChunkSize;
+	static constexpr std::size_t max_chunk_size = MaxChunkSize;
+	static constexpr std::size_t chunk_growth = ChunkGrowth;
+	static constexpr std::size_t min_block_size = MinBlockSize;
+	static constexpr std::size_t max_block_size = MaxBlockSize;
+	static constexpr std::size_t run_size = RunSize;
+	static constexpr std::size_t max_reserved_bytes = MaxReservedBytes;
+	static constexpr std::size_t alignment = Alignment;
+};
+
+//Size-class memory pool behind Allocator.
+//Requests are rounded up to a power-of-two size class (min_block_size ..
+//max_block_size), every class has its own free list and carves fresh blocks
+//from runs taken out of the arena's chunks. Larger requests go straight to operator new.
+//Free blocks are kept in intrusive lists: the link to the next free block is
+//stored in the freed memory itself, so there is no side storage per block.
+//Nothing is allocated up front: the first chunk is requested on the first
+//allocation, and every further chunk grows by chunk_growth up to max_chunk_size.
+//Chunks come from operator new unless another ChunkBacking is given.
+//trim() hands memory of runs without a live block back to the system, either
+//whole chunks or, for chunks still in use, the pages of their free runs.
+template <class Traits = PoolTraits<>>
+class BasicPoolArena {
+public:
+	using traits_type = Traits;
+
+	static constexpr std::size_t initial_chunk_size = Traits::initial_chunk_size;
+	static constexpr std::size_t max_chunk_size = Traits::max_chunk_size;
+	static constexpr std::size_t chunk_growth = Traits::chunk_growth;
+	static constexpr std::size_t min_block_size = Traits::min_block_size;
+	static constexpr std::size_t max_block_size = Traits::max_block_size;
+	static constexpr std::size_t size_class_count = pool_log2(max_block_size) - pool_log2(min_block_size) + 1;
+	static constexpr std::size_t run_size = Traits::run_size;
+	static constexpr std::size_t max_reserved_bytes = Traits::max_reserved_bytes;
+	static constexpr std::size_t alignment = Traits::alignment;
+	static constexpr std::size_t auto_trim_delay = 256;
+
+	using stats_type = PoolStats<min_block_size, size_class_count>;
+
+	explicit BasicPoolArena(unsigned backing = ChunkBacking::heap);
+	BasicPoolArena(const BasicPoolArena&) = delete;
+	BasicPoolArena& operator=(const BasicPoolArena&) = delete;
+	~BasicPoolArena();
+
+	void* allocate(std::size_t bytes);
+	void deallocate(void* pointer, std::size_t bytes) noexcept;
+	//count blocks of bytes each, either all of them or none when it throws
+	void allocate_bulk(std::size_t bytes, std::size_t count, void** blocks);
+	void deallocate_bulk(std::size_t bytes, std::size_t count, void* const* blocks) noexcept;
+	bool try_expand(void* pointer, std::size_t old_bytes, std::size_t new_bytes) noexcept;
+
+	std::size_t reserved_bytes() const noexcept;
+	unsigned backing() const noexcept;
+	stats_type stats() const noexcept;
+
+	std::size_t trim() noexcept;
+	//deallocate notes when pool blocks in use fall below trim_below of the reserved
+	//bytes, and only again after they climbed back above rearm_above; 0 turns it off.
+	//The trim walks every run of every chunk, so it does not run on the deallocate
+	//that noted it, but once the last block is freed, after auto_trim_delay further
+	//deallocate calls, or before a new chunk would be taken, whichever comes first.
+	void set_auto_trim(double trim_below, double rearm_above) noexcept;
+	//runs a trim deallocate asked for right away, returns the bytes given back;
+	//call it off the hot path, e.g. between requests
+	std::size_t maybe_trim() noexcept;
+
+	static std::size_t size_class(std::size_t bytes) noexcept;
+	static std::size_t block_size(std::size_t index) noexcept;
+
+private:
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	struct SizeClass {
+		FreeBlock* free_list;
+		char* run;
+		std::size_t run_left;
+	};
+
+	//header at the start of every chunk, keeps the chunks in a list
+	struct alignas(alignment) Chunk {
+		Chunk* next;
+		std::size_t size;
+	};
+
+	//link at the start of a trimmed run, the rest of the run may be discarded
+	struct FreeRun {
+		FreeRun* next;
+	};
+
+	//the runs of every chunk, indexed by address, built by trim()
+	class RunMap;
+
+	static_assert(pool_is_power_of_two(min_block_size) && pool_is_power_of_two(max_block_size),
+		"block sizes must be powers of two");
+	static_assert(min_block_size <= max_block_size, "min_block_size must not exceed max_block_size");
+	static_assert(min_block_size >= sizeof(FreeBlock), "a free block must fit the free list link");
+	static_assert(min_block_size % alignof(FreeBlock) == 0, "blocks must be aligned for the free list link");
+	static_assert(pool_is_power_of_two(alignment) && alignment >= alignof(std::max_align_t),
+		"alignment must be a power of two of at least alignof(std::max_align_t)");
+	static_assert(alignment <= ChunkBacking::page_size, "chunks can not be aligned beyond a page");
+	static_assert(run_size >= max_block_size && run_size % max_block_size == 0, "a run must hold whole blocks of every class");
+	static_assert(run_size % alignment == 0, "runs must keep the chunk alignment");
+	static_assert(initial_chunk_size >= sizeof(Chunk) + run_size, "the first chunk must hold a run");
+	static_assert(max_chunk_size >= initial_chunk_size, "max_chunk_size must not be below initial_chunk_size");
+	static_assert(chunk_growth >= 1, "chunks can not shrink");
+	static_assert(max_reserved_bytes == 0 || max_reserved_bytes >= initial_chunk_size, "the limit must allow the first chunk");
+
+	void refill(SizeClass& pool_class, std::size_t size);
+	void add_chunk(std::size_t bytes);
+	void update_trim_limits() noexcept;
+	void allocated(std::size_t bytes) noexcept;
+	void freed(std::size_t bytes) noexcept;
+	static char* chunk_begin(Chunk* chunk) noexcept;
+
+	Chunk* chunks;
+	char* chunk_cursor;
+	std::size_t chunk_left;
+	std::size_t next_chunk_size;
+	std::size_t reserved;
+	unsigned chunk_backing;
+	SizeClass classes[size_class_count];
+	FreeRun* free_runs;
+	//bytes of pool blocks in use, kept for auto trim whether statistics are on or not
+	std::size_t in_use;
+	double trim_below;
+	double rearm_above;
+	std::size_t trim_below_bytes;
+	std::size_t rearm_above_bytes;
+	bool trim_armed;
+	bool trim_pending;
+	//deallocate calls left before a pending trim runs
+	std::size_t trim_countdown;
+	PoolStatsRecorder<min_block_size, size_class_count> recorder;
+};
+
+using PoolArena = BasicPoolArena<>;
+
+//blocks of at least a cache line, all aligned to one, for SIMD data and
+//for objects that must not share a line with their neighbours
+using CacheAlignedPoolArena = BasicPoolArena<PoolTraits<1048576, 67108864, 2, 64, 65536, 65536, 0, 64>>;
+
+template <class Traits>
+BasicPoolArena<Traits>::BasicPoolArena(unsigned backing)
+	: chunks(nullptr), chunk_cursor(nullptr), chunk_left(0), next_chunk_size(initial_chunk_size), reserved(0),
+	chunk_backing(backing), free_runs(nullptr), in_use(0), trim_below(0), rearm_above(0), trim_below_bytes(0),
+	rearm_above_bytes(std::numeric_limits<std::size_t>::max()), trim_armed(false), trim_pending(false), trim_countdown(0)
+{
+	for (std::size_t i = 0; i < size_class_count; i++) {
+		classes[i].free_list = nullptr;
+		classes[i].run = nullptr;
+		classes[i].run_left = 0;
+	}
+}
+
+template <class Traits>
+BasicPoolArena<Traits>::~BasicPoolArena() {
+	while (chunks != nullptr) {
+		Chunk* next = chunks->next;
+		ChunkBacking::deallocate(chunks, chunks->size, chunk_backing, alignment);
+		chunks = next;
+	}
+}
+
+template <class Traits>
+void* BasicPoolArena<Traits>::allocate(std::size_t bytes) {
+	if (bytes > max_block_size) {
+		void* block;
+		try {
+			block = alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? ::operator new(bytes, std::align_val_t(alignment))
+				: ::operator new(bytes);
+		}
+		catch (...) {
+			recorder.record_failure();
+			throw;
+		}
+		recorder.record_large_allocate(bytes);
+		return block;
+	}
+
+	std::size_t index = size_class(bytes);
+	SizeClass& pool_class = classes[index];
+	if (pool_class.free_list != nullptr) {
+		FreeBlock* block = pool_class.free_list;
+		pool_class.free_list = block->next;
+		recorder.record_allocate(index);
+		allocated(block_size(index));
+		return block;
+	}
+
+	std::size_t size = block_size(index);
+	if (pool_class.run_left < size) {
+		refill(pool_class, size);
+	}
+	void* block = pool_class.run;
+	pool_class.run += size;
+	pool_class.run_left -= size;
+	recorder.record_allocate(index);
+	allocated(size);
+	return block;
+}
+
+template <class Traits>
+void BasicPoolArena<Traits>::deallocate(void* pointer, std::size_t bytes) noexcept {
+	if (pointer == nullptr) {
+		return;
+	}
+	if (bytes > max_block_size) {
+		if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+			::operator delete(pointer, std::align_val_t(alignment));
+		}
+		else {
+			::operator delete(pointer);
+		}
+		recorder.record_large_deallocate(bytes);
+		return;
+	}
+	std::size_t index = size_class(bytes);
+	recorder.record_deallocate(index);
+	SizeClass& pool_class = classes[index];
+	FreeBlock* block = static_cast<FreeBlock*>(pointer);
+	block->next = pool_class.free_list;
+	pool_class.free_list = block;
+	freed(block_size(index));
+}
+
+//pops what the free list has, then carves the rest from runs,
+//with one statistics update for the whole batch
+template <class Traits>
+void BasicPoolArena<Traits>::allocate_bulk(std::size_t bytes, std::size_t count, void** blocks) {
+	if (bytes > max_block_size) {
+		std::size_t done = 0;
+		try {
+			for (; done < count; done++) {
+				blocks[done] = allocate(bytes);
+			}
+		}
+		catch (...) {
+			deallocate_bulk(bytes, done, blocks);
+			throw;
+		}
+		return;
+	}
+
+	std::size_t index = size_class(bytes);
+	SizeClass& pool_class = classes[index];
+	std::size_t done = 0;
+	while (done < count && pool_class.free_list != nullptr) {
+		FreeBlock* block = pool_class.free_list;
+		pool_class.free_list = block->next;
+		blocks[done++] = block;
+	}
+
+	std::size_t size = block_size(index);
+	while (done < count) {
+		if (pool_class.run_left < size) {
+			try {
+				refill(pool_class, size);
+			}
+			catch (...) {
+				recorder.record_allocate(index, done);
+				allocated(size * done);
+				deallocate_bulk(bytes, done, blocks);
+				throw;
+			}
+		}
+		std::size_t carved = pool_class.run_left / size;
+		if (carved > count - done) {
+			carved = count - done;
+		}
+		for (std::size_t i = 0; i < carved; i++) {
+			blocks[done++] = pool_class.run;
+			pool_class.run += size;
+		}
+		pool_class.run_left -= carved * size;
+	}
+	recorder.record_allocate(index, count);
+	allocated(size * count);
+}
+
+//links the blocks to each other and puts the chain in front of the free list
+template <class Traits>
+void BasicPoolArena<Traits>::deallocate_bulk(std::size_t bytes, std::size_t count, void* const* blocks) noexcept {
+	if (count == 0) {
+		return;
+	}
+	if (bytes > max_block_size) {
+		for (std::size_t i = 0; i < count; i++) {
+			deallocate(blocks[i], bytes);
+		}
+		return;
+	}
+	std::size_t index = size_class(bytes);
+	recorder.record_deallocate(index, count);
+	SizeClass& pool_class = classes[index];
+	FreeBlock* first = static_cast<FreeBlock*>(blocks[0]);
+	FreeBlock* last = first;
+	for (std::size_t i = 1; i < count; i++) {
+		FreeBlock* block = static_cast<FreeBlock*>(blocks[i]);
+		last->next = block;
+		last = block;
+	}
+	last->next = pool_class.free_list;
+	pool_class.free_list = first;
+	freed(block_size(index) * count);
+}
+
+//a block can take any size of its class, the rounding slack is free to grow into
+template <class Traits>
+bool BasicPoolArena<Traits>::try_expand(void* pointer, std::size_t old_bytes, std::size_t new_bytes) noexcept {
+	return pointer != nullptr && old_bytes <= max_block_size && new_bytes <= max_block_size
+		&& size_class(new_bytes) == size_class(old_bytes);
+}
+
+//bytes taken from the system for chunks, blocks above max_block_size are not counted
+template <class Traits>
+std::size_t BasicPoolArena<Traits>::reserved_bytes() const noexcept {
+	return reserved;
+}
+
+//ChunkBacking flags the chunks are taken with, huge_pages is dropped
+//once the system failed to provide them
+template <class Traits>
+unsigned BasicPoolArena<Traits>::backing() const noexcept {
+	return chunk_backing;
+}
+
+//counters are only filled in with POOL_ARENA_STATS
+template <class Traits>
+typename BasicPoolArena<Traits>::stats_type BasicPoolArena<Traits>::stats() const noexcept {
+	std::size_t chunk_count = 0;
+	for (Chunk* chunk = chunks; chunk != nullptr; chunk = chunk->next) {
+		chunk_count++;
+	}
+	return recorder.snapshot(reserved, chunk_count);
+}
+
+template <class Traits>
+class BasicPoolArena<Traits>::RunMap {
+public:
+	//free bytes of a run already on free_runs, and of a run emptied by this trim
+	static constexpr std::size_t trimmed = std::numeric_limits<std::size_t>::max();
+	static constexpr std::size_t emptied = trimmed - 1;
+
+	explicit RunMap(const BasicPoolArena& arena) noexcept;
+
+	//false without chunks or when there was no memory for the map
+	bool valid() const noexcept { return run_count != 0 && free != nullptr; }
+
+	std::size_t chunk_count() const noexcept { return count; }
+	Chunk* chunk(std::size_t index) const noexcept { return sorted[index]; }
+	std::size_t first_run(std::size_t index) const noexcept { return first[index]; }
+	std::size_t end_run(std::size_t index) const noexcept { return first[index + 1]; }
+
+	std::size_t chunk_of(const void* pointer) const noexcept;
+	std::size_t run_of(const void* pointer) const noexcept;
+	std::size_t& free_bytes(std::size_t run) noexcept { return free[run]; }
+	//every run of the chunk is free, and there is at least one
+	bool empty(std::size_t index) const noexcept;
+
+private:
+	std::size_t count;
+	std::size_t run_count;
+	std::unique_ptr<Chunk*[]> sorted;
+	std::unique_ptr<std::size_t[]> first;
+	std::unique_ptr<std::size_t[]> free;
+};
+
+//chunks sorted by address, each followed by the runs carved from it so far:
+//all that fit in a full chunk, the ones before the cursor in the current one
+template <class Traits>
+BasicPoolArena<Traits>::RunMap::RunMap(const BasicPoolArena& arena) noexcept
+	: count(0), run_count(0)
+{
+	for (Chunk* chunk = arena.chunks; chunk != nullptr; chunk = chunk->next) {
+		count++;
+	}
+	sorted.reset(new (std::nothrow) Chunk*[count]);
+	first.reset(new (std::nothrow) std::size_t[count + 1]);
+	if (count == 0 || sorted == nullptr || first == nullptr) {
+		return;
+	}
+	std::size_t i = 0;
+	for (Chunk* chunk = arena.chunks; chunk != nullptr; chunk = chunk->next) {
+		sorted[i++] = chunk;
+	}
+	std::sort(sorted.get(), sorted.get() + count, std::less<Chunk*>());
+	for (i = 0; i < count; i++) {
+		first[i] = run_count;
+		if (sorted[i] == arena.chunks) {
+			run_count += (arena.chunk_cursor - chunk_begin(sorted[i])) / run_size;
+		}
+		else {
+			run_count += (sorted[i]->size - sizeof(Chunk)) / run_size;
+		}
+	}
+	first[count] = run_count;
+	free.reset(new (std::nothrow) std::size_t[run_count]());
+}
+
+template <class Traits>
+std::size_t BasicPoolArena<Traits>::RunMap::chunk_of(const void* pointer) const noexcept {
+	Chunk** next = std::upper_bound(sorted.get(), sorted.get() + count, pointer,
+		[](const void* block, Chunk* chunk) { return std::less<const void*>()(block, chunk); });
+	return next - sorted.get() - 1;
+}
+
+template <class Traits>
+std::size_t BasicPoolArena<Traits>::RunMap::run_of(const void* pointer) const noexcept {
+	std::size_t index = chunk_of(pointer);
+	return first[index] + (static_cast<const char*>(pointer) - chunk_begin(sorted[index])) / run_size;
+}
+
+template <class Traits>
+bool BasicPoolArena<Traits>::RunMap::empty(std::size_t index) const noexcept {
+	if (first[index] == first[index + 1]) {
+		return false;
+	}
+	for (std::size_t run = first[index]; run < first[index + 1]; run++) {
+		if (free[run] != trimmed && free[run] != emptied) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//Finds the runs without a live block by walking the free lists. Chunks made
+//only of such runs go back to the system, except the current one, which starts
+//over and has its pages discarded. Other empty runs are kept on free_runs for
+//refill, with their pages discarded. Returns the bytes given back.
+//Blocks cached outside the arena, e.g. in thread magazines, count as live.
+template <class Traits>
+std::size_t BasicPoolArena<Traits>::trim() noexcept {
+	trim_pending = false;
+	RunMap map(*this);
+	if (!map.valid()) {
+		return 0;
+	}
+
+	for (FreeRun* run = free_runs; run != nullptr; run = run->next) {
+		map.free_bytes(map.run_of(run)) = RunMap::trimmed;
+	}
+	for (std::size_t i = 0; i < size_class_count; i++) {
+		for (FreeBlock* block = classes[i].free_list; block != nullptr; block = block->next) {
+			map.free_bytes(map.run_of(block)) += block_size(i);
+		}
+		if (classes[i].run_left != 0) {
+			map.free_bytes(map.run_of(classes[i].run)) += classes[i].run_left;
+		}
+	}
+	for (std::size_t chunk = 0; chunk < map.chunk_count(); chunk++) {
+		for (std::size_t run = map.first_run(chunk); run < map.end_run(chunk); run++) {
+			if (map.free_bytes(run) == run_size) {
+				map.free_bytes(run) = RunMap::emptied;
+			}
+		}
+	}
+
+	//nothing may point into an emptied run or an empty chunk afterwards
+	for (std::size_t i = 0; i < size_class_count; i++) {
+		FreeBlock** link = &classes[i].free_list;
+		while (*link != nullptr) {
+			if (map.free_bytes(map.run_of(*link)) == RunMap::emptied) {
+				*link = (*link)->next;
+			}
+			else {
+				link = &(*link)->next;
+			}
+		}
+		if (classes[i].run_left != 0 && map.free_bytes(map.run_of(classes[i].run)) == RunMap::emptied) {
+			classes[i].run = nullptr;
+			classes[i].run_left = 0;
+		}
+	}
+	FreeRun** run_link = &free_runs;
+	while (*run_link != nullptr) {
+		if (map.empty(map.chunk_of(*run_link))) {
+			*run_link = (*run_link)->next;
+		}
+		else {
+			run_link = &(*run_link)->next;
+		}
+	}
+
+	std::size_t returned = 0;
+	for (std::size_t chunk = 0; chunk < map.chunk_count(); chunk++) {
+		if (map.empty(chunk)) {
+			continue;
+		}
+		for (std::size_t run = map.first_run(chunk); run < map.end_run(chunk); run++) {
+			if (map.free_bytes(run) == RunMap::emptied) {
+				FreeRun* free_run = reinterpret_cast<FreeRun*>(chunk_begin(map.chunk(chunk)) + (run - map.first_run(chunk)) * run_size);
+				free_run->next = free_runs;
+				free_runs = free_run;
+				returned += ChunkBacking::discard(free_run + 1, run_size - sizeof(FreeRun), chunk_backing);
+			}
+		}
+	}
+
+	Chunk* current = chunks;
+	Chunk** chunk_link = &chunks;
+	while (*chunk_link != nullptr) {
+		Chunk* chunk = *chunk_link;
+		if (!map.empty(map.chunk_of(chunk))) {
+			chunk_link = &chunk->next;
+		}
+		else if (chunk == current) {
+			chunk_cursor = chunk_begin(chunk);
+			chunk_left = chunk->size - sizeof(Chunk);
+			returned += ChunkBacking::discard(chunk_cursor, chunk_left, chunk_backing);
+			chunk_link = &chunk->next;
+		}
+		else {
+			*chunk_link = chunk->next;
+			reserved -= chunk->size;
+			returned += chunk->size;
+			ChunkBacking::deallocate(chunk, chunk->size, chunk_backing, alignment);
+		}
+	}
+	update_trim_limits();
+	recorder.record_trim(returned);
+	return returned;
+}
+
+template <class Traits>
+void BasicPoolArena<Traits>::set_auto_trim(double trim_below, double rearm_above) noexcept {
+	this->trim_below = trim_below;
+	this->rearm_above = rearm_above;
+	update_trim_limits();
+	trim_armed = in_use > rearm_above_bytes;
+	trim_pending = false;
+}
+
+template <class Traits>
+std::size_t BasicPoolArena<Traits>::maybe_trim() noexcept {
+	if (!trim_pending) {
+		return 0;
+	}
+	return trim();
+}
+
+//index of the smallest class that fits bytes
+template <class Traits>
+std::size_t BasicPoolArena<Traits>::size_class(std::size_t bytes) noexcept {
+	if (bytes <= min_block_size) {
+		return 0;
+	}
+#if defined(__GNUC__)
+	return sizeof(unsigned long long) * 8 - __builtin_clzll(bytes - 1) - pool_log2(min_block_size);
+#else
+	std::size_t index = 0;
+	for (std::size_t size = min_block_size; size < bytes; size <<= 1) {
+		index++;
+	}
+	return index;
+#endif
+}
+
+template <class Traits>
+std::size_t BasicPoolArena<Traits>::block_size(std::size_t index) noexcept {
+	return min_block_size << index;
+}
+
+//takes the next run out of the current chunk, the tail of the previous run is dropped
+template <class Traits>
+void BasicPoolArena<Traits>::refill(SizeClass& pool_class, std::size_t size) {
+	std::size_t bytes = size > run_size ? size : run_size;
+	if (free_runs != nullptr && bytes == run_size) {
+		FreeRun* run = free_runs;
+		free_runs = run->next;
+		pool_class.run = reinterpret_cast<char*>(run);
+		pool_class.run_left = run_size;
+		return;
+	}
+	if (chunk_left < bytes) {
+		//a pending trim may free runs or restart the current chunk
+		if (trim_pending) {
+			trim();
+			refill(pool_class, size);
+			return;
+		}
+		add_chunk(bytes);
+	}
+	pool_class.run = chunk_cursor;
+	pool_class.run_left = bytes;
+	chunk_cursor += bytes;
+	chunk_left -= bytes;
+}
+
+//starts a new chunk of at least bytes usable bytes, the rest of the current one is dropped.
+//Close to max_reserved_bytes the chunk shrinks to what is left of the limit.
+template <class Traits>
+void BasicPoolArena<Traits>::add_chunk(std::size_t bytes) {
+	std::size_t size = next_chunk_size;
+	while (size - sizeof(Chunk) < bytes) {
+		size *= 2;
+	}
+	if (max_reserved_bytes != 0 && (reserved >= max_reserved_bytes || size > max_reserved_bytes - reserved)) {
+		//huge page rounding can take reserved past the limit
+		size = reserved >= max_reserved_bytes ? 0 : max_reserved_bytes - reserved;
+		if (size < sizeof(Chunk) + bytes) {
+			recorder.record_failure();
+			throw std::bad_alloc();
+		}
+	}
+	Chunk* chunk;
+	try {
+		chunk = static_cast<Chunk*>(ChunkBacking::allocate(size, chunk_backing, alignment));
+	}
+	catch (...) {
+		recorder.record_failure();
+		throw;
+	}
+	chunk->next = chunks;
+	chunk->size = size;
+	chunks = chunk;
+	reserved += size;
+	chunk_cursor = chunk_begin(chunk);
+	chunk_left = size - sizeof(Chunk);
+	if (next_chunk_size < max_chunk_size) {
+		next_chunk_size = next_chunk_size > max_chunk_size / chunk_growth ? max_chunk_size : next_chunk_size * chunk_growth;
+	}
+	update_trim_limits();
+}
+
+template <class Traits>
+void BasicPoolArena<Traits>::update_trim_limits() noexcept {
+	if (trim_below <= 0) {
+		trim_below_bytes = 0;
+		rearm_above_bytes = std::numeric_limits<std::size_t>::max();
+		return;
+	}
+	trim_below_bytes = static_cast<std::size_t>(trim_below * reserved);
+	rearm_above_bytes = static_cast<std::size_t>(rearm_above * reserved);
+}
+
+template <class Traits>
+void BasicPoolArena<Traits>::allocated(std::size_t bytes) noexcept {
+	in_use += bytes;
+	if (!trim_armed && in_use > rearm_above_bytes) {
+		trim_armed = true;
+	}
+}
+
+template <class Traits>
+void BasicPoolArena<Traits>::freed(std::size_t bytes) noexcept {
+	in_use -= bytes;
+	if (trim_armed && in_use < trim_below_bytes) {
+		trim_armed = false;
+		trim_pending = true;
+		trim_countdown = auto_trim_delay;
+	}
+	else if (trim_pending) {
+		trim_countdown--;
+	}
+	if (trim_pending && (in_use == 0 || trim_countdown == 0)) {
+		trim();
+	}
+}
+
+template <class Traits>
+char* BasicPoolArena<Traits>::chunk_begin(Chunk* chunk) noexcept {
+	return reinterpret_cast<char*>(chunk + 1);
+}
\ No newline at end of file
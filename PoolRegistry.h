@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "Allocator.h"
+
+//Process-wide pools, one per block size and alignment. Containers whose
+//nodes have the same size and alignment share one pool instead of keeping
+//a private pool each. The pools are never destroyed, so containers with
+//static storage duration can still free into them at exit.
+//Arena must be safe to use from several threads, every thread shares the same pools.
+template <class Arena = ConcurrentPoolArena>
+class PoolRegistry {
+public:
+	//the pool for objects of size bytes; sizes are rounded up to a power of two
+	static std::shared_ptr<Arena> pool(std::size_t size, std::size_t alignment);
+
+	static std::size_t pool_count();
+	//bytes reserved by all pools of the registry
+	static std::size_t reserved_bytes();
+
+private:
+	struct Entry {
+		std::size_t size;
+		std::size_t alignment;
+		std::shared_ptr<Arena> arena;
+	};
+
+	struct Pools {
+		std::mutex mutex;
+		std::vector<Entry> entries;
+	};
+
+	static std::size_t round_size(std::size_t size) noexcept;
+	static Pools& pools();
+};
+
+//Stateless pool allocator over the registry pool for sizeof(T) and alignof(T).
+//Rebinding picks the pool of the new type, so std::list<T, SharedPoolAllocator<T>>
+//takes its nodes from the pool shared by all nodes of that size. All
+//instances are equal, containers move and swap their storage freely.
+template <class T, class Arena = ConcurrentPoolArena>
+class SharedPoolAllocator {
+public:
+	static_assert(alignof(T) <= Arena::alignment, "pool blocks are not aligned beyond Arena::alignment");
+
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::false_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::false_type;
+	using is_always_equal = std::true_type;
+
+	SharedPoolAllocator() noexcept = default;
+	template <class U>
+	SharedPoolAllocator(const SharedPoolAllocator<U, Arena>&) noexcept;
+
+	T* allocate(std::size_t n);
+	void deallocate(T* pointer, std::size_t n) noexcept;
+	void allocate_bulk(std::size_t n, T** pointers);
+	void deallocate_bulk(T* const* pointers, std::size_t n) noexcept;
+	bool try_expand(T* pointer, std::size_t old_n, std::size_t new_n) noexcept;
+
+	typename Arena::stats_type stats() const;
+	static std::shared_ptr<Arena> shared_arena();
+
+	template <class U, class F, class A>
+	friend bool operator==(const SharedPoolAllocator<U, A>&, const SharedPoolAllocator<F, A>&) noexcept;
+
+	template <class U, class F, class A>
+	friend bool operator!=(const SharedPoolAllocator<U, A>&, const SharedPoolAllocator<F, A>&) noexcept;
+
+private:
+	static Arena& arena();
+};
+
+template <class Arena>
+std::shared_ptr<Arena> PoolRegistry<Arena>::pool(std::size_t size, std::size_t alignment) {
+	std::size_t rounded = round_size(size);
+	Pools& registry = pools();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	for (Entry& entry : registry.entries) {
+		if (entry.size == rounded && entry.alignment == alignment) {
+			return entry.arena;
+		}
+	}
+	registry.entries.push_back(Entry{ rounded, alignment, std::make_shared<Arena>() });
+	return registry.entries.back().arena;
+}
+
+template <class Arena>
+std::size_t PoolRegistry<Arena>::pool_count() {
+	Pools& registry = pools();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	return registry.entries.size();
+}
+
+template <class Arena>
+std::size_t PoolRegistry<Arena>::reserved_bytes() {
+	Pools& registry = pools();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	std::size_t bytes = 0;
+	for (const Entry& entry : registry.entries) {
+		bytes += entry.arena->reserved_bytes();
+	}
+	return bytes;
+}
+
+template <class Arena>
+std::size_t PoolRegistry<Arena>::round_size(std::size_t size) noexcept {
+	std::size_t rounded = 1;
+	while (rounded < size && rounded <= std::numeric_limits<std::size_t>::max() / 2) {
+		rounded <<= 1;
+	}
+	return rounded < size ? size : rounded;
+}
+
+//leaked on purpose, see above
+template <class Arena>
+typename PoolRegistry<Arena>::Pools& PoolRegistry<Arena>::pools() {
+	static Pools* registry = new Pools();
+	return *registry;
+}
+
+template <class T, class Arena>
+template <class U>
+SharedPoolAllocator<T, Arena>::SharedPoolAllocator(const SharedPoolAllocator<U, Arena>&) noexcept {}
+
+template <class T, class Arena>
+T* SharedPoolAllocator<T, Arena>::allocate(std::size_t n) {
+	if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+		throw std::bad_alloc();
+	}
+	return static_cast<T*>(arena().allocate(n * sizeof(T)));
+}
+
+template <class T, class Arena>
+void SharedPoolAllocator<T, Arena>::deallocate(T* pointer, std::size_t n) noexcept {
+	arena().deallocate(pointer, n * sizeof(T));
+}
+
+//same batching as Allocator::allocate_bulk
+template <class T, class Arena>
+void SharedPoolAllocator<T, Arena>::allocate_bulk(std::size_t n, T** pointers) {
+	void* batch[Allocator<T, Arena>::bulk_batch_size];
+	std::size_t done = 0;
+	try {
+		while (done < n) {
+			std::size_t count = n - done < std::size(batch) ? n - done : std::size(batch);
+			arena().allocate_bulk(sizeof(T), count, batch);
+			for (std::size_t i = 0; i < count; i++) {
+				pointers[done + i] = static_cast<T*>(batch[i]);
+			}
+			done += count;
+		}
+	}
+	catch (...) {
+		deallocate_bulk(pointers, done);
+		throw;
+	}
+}
+
+template <class T, class Arena>
+void SharedPoolAllocator<T, Arena>::deallocate_bulk(T* const* pointers, std::size_t n) noexcept {
+	void* batch[Allocator<T, Arena>::bulk_batch_size];
+	for (std::size_t done = 0; done < n; ) {
+		std::size_t count = n - done < std::size(batch) ? n - done : std::size(batch);
+		for (std::size_t i = 0; i < count; i++) {
+			batch[i] = pointers[done + i];
+		}
+		arena().deallocate_bulk(sizeof(T), count, batch);
+		done += count;
+	}
+}
+
+template <class T, class Arena>
+bool SharedPoolAllocator<T, Arena>::try_expand(T* pointer, std::size_t old_n, std::size_t new_n) noexcept {
+	if (new_n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+		return false;
+	}
+	return arena().try_expand(pointer, old_n * sizeof(T), new_n * sizeof(T));
+}
+
+//snapshot of the pool shared by every allocator of this size and alignment
+template <class T, class Arena>
+typename Arena::stats_type SharedPoolAllocator<T, Arena>::stats() const {
+	return arena().stats();
+}
+
+template <class T, class Arena>
+std::shared_ptr<Arena> SharedPoolAllocator<T, Arena>::shared_arena() {
+	return PoolRegistry<Arena>::pool(sizeof(T), alignof(T));
+}
+
+//looked up in the registry once per type; a plain pointer, so it outlives
+//every static destructor like the registry does
+template <class T, class Arena>
+Arena& SharedPoolAllocator<T, Arena>::arena() {
+	static Arena* const pool = PoolRegistry<Arena>::pool(sizeof(T), alignof(T)).get();
+	return *pool;
+}
+
+template <class U, class F, class A>
+bool operator==(const SharedPoolAllocator<U, A>&, const SharedPoolAllocator<F, A>&) noexcept {
+	return true;
+}
+
+template <class U, class F, class A>
+bool operator!=(const SharedPoolAllocator<U, A>&, const SharedPoolAllocator<F, A>&) noexcept {
+	return false;
+}
\ No newline at end of file
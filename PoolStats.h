@@ -0,0 +1,217 @@
+#pragma once
+#include <cstddef>
+#include <chrono>
+#include <ostream>
+
+//Pool statistics are compiled in with -DPOOL_ARENA_STATS=1 and left out with
+//-DPOOL_ARENA_STATS=0. Without it they are collected in debug builds only.
+//With statistics off stats() still reports reserved bytes and chunks,
+//every counter stays zero.
+#ifndef POOL_ARENA_STATS
+#ifdef NDEBUG
+#define POOL_ARENA_STATS 0
+#else
+#define POOL_ARENA_STATS 1
+#endif
+#endif
+
+//snapshot of a pool, taken by stats()
+template <std::size_t MinBlockSize, std::size_t ClassCount>
+struct PoolStats {
+	static constexpr bool enabled = POOL_ARENA_STATS != 0;
+
+	std::size_t allocations;
+	std::size_t deallocations;
+	std::size_t failed_allocations;
+	//requests above the largest size class, served by operator new
+	std::size_t large_allocations;
+	//block sizes, not requested sizes, so rounding waste shows up here
+	std::size_t bytes_in_use;
+	std::size_t peak_bytes_in_use;
+	std::size_t reserved_bytes;
+	std::size_t chunks;
+	//trim() calls, automatic ones included, and the bytes they gave back to the system
+	std::size_t trims;
+	std::size_t trimmed_bytes;
+	//allocations per second over the last sampling interval, 0 before the first one ends
+	double allocation_rate;
+
+	std::size_t class_allocations[ClassCount];
+	std::size_t class_in_use[ClassCount];
+
+	static std::size_t block_size(std::size_t index) noexcept { return MinBlockSize << index; }
+
+	void dump(std::ostream& out) const;
+	void dump_json(std::ostream& out) const;
+};
+
+//the counters behind PoolStats, kept by the arena
+template <std::size_t MinBlockSize, std::size_t ClassCount>
+class PoolStatsRecorder {
+public:
+	using stats_type = PoolStats<MinBlockSize, ClassCount>;
+
+	//the rate is sampled once this many blocks were handed out since the last sample,
+	//so the clock is rarely read; a bulk allocation counts every block
+	static constexpr std::size_t sample_interval = 4096;
+
+	PoolStatsRecorder() noexcept;
+
+	void record_allocate(std::size_t index, std::size_t count = 1) noexcept;
+	void record_deallocate(std::size_t index, std::size_t count = 1) noexcept;
+	void record_large_allocate(std::size_t bytes) noexcept;
+	void record_large_deallocate(std::size_t bytes) noexcept;
+	void record_failure() noexcept;
+	void record_trim(std::size_t bytes) noexcept;
+
+	stats_type snapshot(std::size_t reserved_bytes, std::size_t chunks) const noexcept;
+
+private:
+	void add_in_use(std::size_t bytes, std::size_t count = 1) noexcept;
+	void sample() noexcept;
+
+#if POOL_ARENA_STATS
+	stats_type counters;
+	std::chrono::steady_clock::time_point last_sample;
+	std::size_t last_sample_allocations;
+	bool sampled;
+#endif
+};
+
+template <std::size_t MinBlockSize, std::size_t ClassCount>
+void PoolStats<MinBlockSize, ClassCount>::dump(std::ostream& out) const {
+	out << "pool: " << allocations << " allocations, " << deallocations << " deallocations, "
+		<< failed_allocations << " failed, " << large_allocations << " large\n";
+	out << "bytes: " << bytes_in_use << " in use, " << peak_bytes_in_use << " peak, "
+		<< reserved_bytes << " reserved in " << chunks << " chunks\n";
+	out << "trims: " << trims << ", " << trimmed_bytes << " bytes given back\n";
+	out << "rate: " << allocation_rate << " allocations/s\n";
+	for (std::size_t i = 0; i < ClassCount; i++) {
+		if (class_allocations[i] != 0) {
+			out << "class " << block_size(i) << ": " << class_allocations[i] << " allocations, "
+				<< class_in_use[i] << " in use\n";
+		}
+	}
+}
+
+template <std::size_t MinBlockSize, std::size_t ClassCount>
+void PoolStats<MinBlockSize, ClassCount>::dump_json(std::ostream& out) const {
+	out << "{\"enabled\":" << (enabled ? "true" : "false")
+		<< ",\"allocations\":" << allocations
+		<< ",\"deallocations\":" << deallocations
+		<< ",\"failed_allocations\":" << failed_allocations
+		<< ",\"large_allocations\":" << large_allocations
+		<< ",\"bytes_in_use\":" << bytes_in_use
+		<< ",\"peak_bytes_in_use\":" << peak_bytes_in_use
+		<< ",\"reserved_bytes\":" << reserved_bytes
+		<< ",\"chunks\":" << chunks
+		<< ",\"trims\":" << trims
+		<< ",\"trimmed_bytes\":" << trimmed_bytes
+		<< ",\"allocation_rate\":" << allocation_rate
+		<< ",\"classes\":[";
+	for (std::size_t i = 0; i < ClassCount; i++) {
+		out << (i == 0 ? "" : ",") << "{\"block_size\":" << block_size(i)
+			<< ",\"allocations\":" << class_allocations[i]
+			<< ",\"in_use\":" << class_in_use[i] << "}";
+	}
+	out << "]}";
+}
+
+template <std::size_t MinBlockSize, std::size_t ClassCount>
+PoolStatsRecorder<MinBlockSize, ClassCount>::PoolStatsRecorder() noexcept
+#if POOL_ARENA_STATS
+	: counters(), last_sample_allocations(0), sampled(false)
+#endif
+{}
+
+template <std::size_t MinBlockSize, std::size_t ClassCount>
+void PoolStatsRecorder<MinBlockSize, ClassCount>::record_allocate(std::size_t index, std::size_t count) noexcept {
+#if POOL_ARENA_STATS
+	counters.class_allocations[index] += count;
+	counters.class_in_use[index] += count;
+	add_in_use(stats_type::block_size(index) * count, count);
+#endif
+}
+
+template <std::size_t MinBlockSize, std::size_t ClassCount>
+void PoolStatsRecorder<MinBlockSize, ClassCount>::record_deallocate(std::size_t index, std::size_t count) noexcept {
+#if POOL_ARENA_STATS
+	counters.deallocations += count;
+	counters.class_in_use[index] -= count;
+	counters.bytes_in_use -= stats_type::block_size(index) * count;
+#endif
+}
+
+template <std::size_t MinBlockSize, std::size_t ClassCount>
+void PoolStatsRecorder<MinBlockSize, ClassCount>::record_large_allocate(std::size_t bytes) noexcept {
+#if POOL_ARENA_STATS
+	counters.large_allocations++;
+	add_in_use(bytes);
+#endif
+}
+
+template <std::size_t MinBlockSize, std::size_t ClassCount>
+void PoolStatsRecorder<MinBlockSize, ClassCount>::record_large_deallocate(std::size_t bytes) noexcept {
+#if POOL_ARENA_STATS
+	counters.deallocations++;
+	counters.bytes_in_use -= bytes;
+#endif
+}
+
+template <std::size_t MinBlockSize, std::size_t ClassCount>
+void PoolStatsRecorder<MinBlockSize, ClassCount>::record_failure() noexcept {
+#if POOL_ARENA_STATS
+	counters.failed_allocations++;
+#endif
+}
+
+template <std::size_t MinBlockSize, std::size_t ClassCount>
+void PoolStatsRecorder<MinBlockSize, ClassCount>::record_trim(std::size_t bytes) noexcept {
+#if POOL_ARENA_STATS
+	counters.trims++;
+	counters.trimmed_bytes += bytes;
+#endif
+}
+
+template <std::size_t MinBlockSize, std::size_t ClassCount>
+typename PoolStatsRecorder<MinBlockSize, ClassCount>::stats_type
+PoolStatsRecorder<MinBlockSize, ClassCount>::snapshot(std::size_t reserved_bytes, std::size_t chunks) const noexcept {
+#if POOL_ARENA_STATS
+	stats_type stats = counters;
+#else
+	stats_type stats = stats_type();
+#endif
+	stats.reserved_bytes = reserved_bytes;
+	stats.chunks = chunks;
+	return stats;
+}
+
+template <std::size_t MinBlockSize, std::size_t ClassCount>
+void PoolStatsRecorder<MinBlockSize, ClassCount>::add_in_use(std::size_t bytes, std::size_t count) noexcept {
+#if POOL_ARENA_STATS
+	counters.allocations += count;
+	counters.bytes_in_use += bytes;
+	if (counters.bytes_in_use > counters.peak_bytes_in_use) {
+		counters.peak_bytes_in_use = counters.bytes_in_use;
+	}
+	if (counters.allocations - last_sample_allocations >= sample_interval) {
+		sample();
+	}
+#endif
+}
+
+template <std::size_t MinBlockSize, std::size_t ClassCount>
+void PoolStatsRecorder<MinBlockSize, ClassCount>::sample() noexcept {
+#if POOL_ARENA_STATS
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (sampled) {
+		std::chrono::duration<double> elapsed = now - last_sample;
+		if (elapsed.count() > 0) {
+			counters.allocation_rate = (counters.allocations - last_sample_allocations) / elapsed.count();
+		}
+	}
+	last_sample = now;
+	last_sample_allocations = counters.allocations;
+	sampled = true;
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+//trait: objects of T can be moved to new storage by copying their bytes,
+//after which the old storage is simply forgotten (no destructor call).
+//Specialize it for own types that own resources but do not point to themselves.
+template <class T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <class T>
+struct is_trivially_relocatable<std::allocator<T>> : std::true_type {};
+
+template <class T>
+constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+//moves count objects from source to uninitialized dest and ends their lifetime in source.
+//Ranges must not overlap.
+template <class Allocator, class T>
+void relocate(Allocator& alloc, T* source, std::size_t count, T* dest) {
+	if (count == 0) {
+		return;
+	}
+	if constexpr (is_trivially_relocatable_v<T>) {
+		std::memcpy(static_cast<void*>(dest), static_cast<const void*>(source), count * sizeof(T));
+	}
+	else {
+		for (std::size_t i = 0; i < count; i++) {
+			std::allocator_traits<Allocator>::construct(alloc, dest + i, std::move(source[i]));
+			std::allocator_traits<Allocator>::destroy(alloc, source + i);
+		}
+	}
+}
+
+//same as relocate, but ranges may overlap (shifts inside one buffer)
+template <class Allocator, class T>
+void relocate_overlapping(Allocator& alloc, T* source, std::size_t count, T* dest) {
+	if (count == 0 || source == dest) {
+		return;
+	}
+	if constexpr (is_trivially_relocatable_v<T>) {
+		std::memmove(static_cast<void*>(dest), static_cast<const void*>(source), count * sizeof(T));
+	}
+	else if (dest < source) {
+		for (std::size_t i = 0; i < count; i++) {
+			std::allocator_traits<Allocator>::construct(alloc, dest + i, std::move(source[i]));
+			std::allocator_traits<Allocator>::destroy(alloc, source + i);
+		}
+	}
+	else {
+		for (std::size_t i = count; i > 0; i--) {
+			std::allocator_traits<Allocator>::construct(alloc, dest + i - 1, std::move(source[i - 1]));
+			std::allocator_traits<Allocator>::destroy(alloc, source + i - 1);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,421 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <initializer_list>
+#include "vector.h"
+
+//inline storage for N elements, lives inside SmallVector itself
+template <class T, std::size_t N>
+struct SmallVectorBuffer {
+	static_assert(N > 0, "SmallVector needs room for at least one inline element");
+
+	alignas(T) unsigned char storage[N * sizeof(T)];
+	bool in_use = false;
+
+	T* inline_data() noexcept { return reinterpret_cast<T*>(storage); }
+};
+
+//hands out the inline buffer while it is free and the request fits,
+//everything else goes to the heap allocator
+template <class T, std::size_t N, class HeapAllocator = std::allocator<T>>
+class SmallVectorAllocator {
+public:
+	using value_type = T;
+	using heap_allocator_type = HeapAllocator;
+	using propagate_on_container_copy_assignment = std::false_type;
+	using propagate_on_container_move_assignment = std::false_type;
+	using propagate_on_container_swap = std::false_type;
+	using is_always_equal = std::false_type;
+
+	SmallVectorAllocator(SmallVectorBuffer<T, N>* buffer, const HeapAllocator& heap);
+
+	T* allocate(std::size_t n);
+	void deallocate(T* pointer, std::size_t n);
+
+	bool is_inline(const T* pointer) const noexcept;
+	heap_allocator_type& heap() noexcept;
+	const heap_allocator_type& heap() const noexcept;
+
+	template <class U, std::size_t M, class H>
+	friend bool operator==(const SmallVectorAllocator<U, M, H>& lhs, const SmallVectorAllocator<U, M, H>& rhs) noexcept;
+
+	template <class U, std::size_t M, class H>
+	friend bool operator!=(const SmallVectorAllocator<U, M, H>& lhs, const SmallVectorAllocator<U, M, H>& rhs) noexcept;
+
+private:
+	SmallVectorBuffer<T, N>* _buffer;
+	HeapAllocator _heap;
+};
+
+template <class T, std::size_t N, class HeapAllocator>
+SmallVectorAllocator<T, N, HeapAllocator>::SmallVectorAllocator(SmallVectorBuffer<T, N>* buffer, const HeapAllocator& heap)
+	: _buffer(buffer), _heap(heap) {}
+
+template <class T, std::size_t N, class HeapAllocator>
+T* SmallVectorAllocator<T, N, HeapAllocator>::allocate(std::size_t n) {
+	if (n == 0) {
+		return nullptr;
+	}
+	if (n <= N && !_buffer->in_use) {
+		_buffer->in_use = true;
+		return _buffer->inline_data();
+	}
+	return std::allocator_traits<HeapAllocator>::allocate(_heap, n);
+}
+
+template <class T, std::size_t N, class HeapAllocator>
+void SmallVectorAllocator<T, N, HeapAllocator>::deallocate(T* pointer, std::size_t n) {
+	if (pointer == nullptr) {
+		return;
+	}
+	if (is_inline(pointer)) {
+		_buffer->in_use = false;
+		return;
+	}
+	std::allocator_traits<HeapAllocator>::deallocate(_heap, pointer, n);
+}
+
+template <class T, std::size_t N, class HeapAllocator>
+bool SmallVectorAllocator<T, N, HeapAllocator>::is_inline(const T* pointer) const noexcept {
+	return pointer == _buffer->inline_data();
+}
+
+template <class T, std::size_t N, class HeapAllocator>
+typename SmallVectorAllocator<T, N, HeapAllocator>::heap_allocator_type& SmallVectorAllocator<T, N, HeapAllocator>::heap() noexcept {
+	return _heap;
+}
+
+template <class T, std::size_t N, class HeapAllocator>
+const typename SmallVectorAllocator<T, N, HeapAllocator>::heap_allocator_type& SmallVectorAllocator<T, N, HeapAllocator>::heap() const noexcept {
+	return _heap;
+}
+
+template <class U, std::size_t M, class H>
+bool operator==(const SmallVectorAllocator<U, M, H>& lhs, const SmallVectorAllocator<U, M, H>& rhs) noexcept {
+	return lhs._buffer == rhs._buffer;
+}
+
+template <class U, std::size_t M, class H>
+bool operator!=(const SmallVectorAllocator<U, M, H>& lhs, const SmallVectorAllocator<U, M, H>& rhs) noexcept {
+	return !(lhs == rhs);
+}
+
+//Vector that keeps up to N elements inline and only spills to Allocator
+//when it grows past them. The buffer base is constructed before the Vector
+//base, so the Vector's allocator can point into it.
+//The Vector base is private: its move, move assignment and swap would hand
+//the inline buffer of one SmallVector to another, so only the rest of its
+//interface is exported.
+template <class T, std::size_t N, class Allocator = std::allocator<T>, class GrowthPolicy = OneAndHalfGrowth,
+	class BoundsCheck = DefaultBoundsCheck>
+class SmallVector
+	: private SmallVectorBuffer<T, N>,
+	private Vector<T, SmallVectorAllocator<T, N, Allocator>, GrowthPolicy, BoundsCheck> {
+public:
+	using base_type = Vector<T, SmallVectorAllocator<T, N, Allocator>, GrowthPolicy, BoundsCheck>;
+	using typename base_type::value_type;
+	using typename base_type::reference;
+	using typename base_type::const_reference;
+	using typename base_type::allocator_type;
+	using typename base_type::difference_type;
+	using typename base_type::size_type;
+	using typename base_type::pointer;
+	using typename base_type::const_pointer;
+	using typename base_type::iterator;
+	using typename base_type::const_iterator;
+	using typename base_type::reverse_iterator;
+	using typename base_type::const_reverse_iterator;
+	using heap_allocator_type = Allocator;
+
+	static constexpr size_type inline_capacity = N;
+
+	//constructors
+	explicit SmallVector(const Allocator& alloc = Allocator());
+	explicit SmallVector(size_type count, const Allocator& alloc = Allocator());
+	SmallVector(size_type count, const T& value, const Allocator& alloc = Allocator());
+	template <typename InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+	SmallVector(InputIterator first, InputIterator last, const Allocator& alloc = Allocator());
+	SmallVector(std::initializer_list<T> init, const Allocator& alloc = Allocator());
+
+	SmallVector(const SmallVector& other);
+	SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value
+		&& std::allocator_traits<Allocator>::is_always_equal::value);
+
+	//value assign
+	SmallVector& operator=(const SmallVector& other);
+	SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value
+		&& std::allocator_traits<Allocator>::is_always_equal::value);
+	SmallVector& operator=(std::initializer_list<T> ilist);
+	using base_type::assign;
+	using base_type::get_allocator;
+
+	//element access
+	using base_type::at;
+	using base_type::operator[];
+	using base_type::front;
+	using base_type::back;
+	using base_type::data;
+
+	//iterators
+	using base_type::begin;
+	using base_type::cbegin;
+	using base_type::end;
+	using base_type::cend;
+	using base_type::rbegin;
+	using base_type::crbegin;
+	using base_type::rend;
+	using base_type::crend;
+
+	//capacity
+	using base_type::empty;
+	using base_type::size;
+	using base_type::max_size;
+	using base_type::reserve;
+	using base_type::capacity;
+	bool is_inline() const noexcept;
+	void shrink_to_fit();
+
+	//modifiers
+	using base_type::clear;
+	using base_type::insert;
+	using base_type::emplace;
+	using base_type::erase;
+	using base_type::push_back;
+	using base_type::emplace_back;
+	using base_type::pop_back;
+	using base_type::resize;
+	using base_type::resize_default_init;
+	using base_type::resize_and_overwrite;
+	void swap(SmallVector& other);
+
+	//operators
+	template <class U, std::size_t M, class A, class G, class C>
+	friend bool operator==(const SmallVector<U, M, A, G, C>& lhs, const SmallVector<U, M, A, G, C>& rhs);
+
+	template <class U, std::size_t M, class A, class G, class C>
+	friend bool operator!=(const SmallVector<U, M, A, G, C>& lhs, const SmallVector<U, M, A, G, C>& rhs);
+
+	template <class U, std::size_t M, class A, class G, class C>
+	friend bool operator<(const SmallVector<U, M, A, G, C>& lhs, const SmallVector<U, M, A, G, C>& rhs);
+
+	template <class U, std::size_t M, class A, class G, class C>
+	friend bool operator<=(const SmallVector<U, M, A, G, C>& lhs, const SmallVector<U, M, A, G, C>& rhs);
+
+	template <class U, std::size_t M, class A, class G, class C>
+	friend bool operator>(const SmallVector<U, M, A, G, C>& lhs, const SmallVector<U, M, A, G, C>& rhs);
+
+	template <class U, std::size_t M, class A, class G, class C>
+	friend bool operator>=(const SmallVector<U, M, A, G, C>& lhs, const SmallVector<U, M, A, G, C>& rhs);
+
+private:
+	using buffer_type = SmallVectorBuffer<T, N>;
+
+	void claim_inline_buffer() noexcept;
+	void release_heap_storage() noexcept;
+	void take(SmallVector& other);
+	bool can_steal_from(const SmallVector& other) const noexcept;
+};
+
+//constructors
+template <class T, std::size_t N, class Allocator, class GrowthPolicy, class BoundsCheck>
+SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>::SmallVector(const Allocator& alloc)
+	: buffer_type(), base_type(allocator_type(this, alloc))
+{
+	claim_inline_buffer();
+}
+
+template <class T, std::size_t N, class Allocator, class GrowthPolicy, class BoundsCheck>
+SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>::SmallVector(size_type count, const Allocator& alloc)
+	: buffer_type(), base_type(count, allocator_type(this, alloc))
+{
+	claim_inline_buffer();
+}
+
+template <class T, std::size_t N, class Allocator, class GrowthPolicy, class BoundsCheck>
+SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>::SmallVector(size_type count, const T& value, const Allocator& alloc)
+	: buffer_type(), base_type(count, value, allocator_type(this, alloc))
+{
+	claim_inline_buffer();
+}
+
+template <class T, std::size_t N, class Allocator, class GrowthPolicy, class BoundsCheck>
+template <class InputIterator, class>
+SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>::SmallVector(InputIterator first, InputIterator last, const Allocator& alloc)
+	: buffer_type(), base_type(first, last, allocator_type(this, alloc))
+{
+	claim_inline_buffer();
+}
+
+template <class T, std::size_t N, class Allocator, class GrowthPolicy, class BoundsCheck>
+SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>::SmallVector(std::initializer_list<T> init, const Allocator& alloc)
+	: buffer_type(), base_type(init, allocator_type(this, alloc))
+{
+	claim_inline_buffer();
+}
+
+template <class T, std::size_t N, class Allocator, class GrowthPolicy, class BoundsCheck>
+SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>::SmallVector(const SmallVector& other)
+	: buffer_type(),
+	base_type(allocator_type(this, std::allocator_traits<Allocator>::select_on_container_copy_construction(other._allocator.heap())))
+{
+	claim_inline_buffer();
+	this->reserve(other._size);
+	this->copy_vector(other);
+	this->_size = other._size;
+}
+
+template <class T, std::size_t N, class Allocator, class GrowthPolicy, class BoundsCheck>
+SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>::SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value
+	&& std::allocator_traits<Allocator>::is_always_equal::value)
+	: buffer_type(), base_type(allocator_type(this, other._allocator.heap()))
+{
+	claim_inline_buffer();
+	take(other);
+}
+
+//value assign
+template <class T, std::size_t N, class Allocator, class GrowthPolicy, class BoundsCheck>
+SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>& SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>::operator=(const SmallVector& other) {
+	if (this != &other) {
+		this->assign(other.begin(), other.end());
+	}
+	return *this;
+}
+
+template <class T, std::size_t N, class Allocator, class GrowthPolicy, class BoundsCheck>
+SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>& SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>::operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value
+	&& std::allocator_traits<Allocator>::is_always_equal::value) {
+	if (this != &other) {
+		this->clear();
+		release_heap_storage();
+		take(other);
+	}
+	return *this;
+}
+
+template <class T, std::size_t N, class Allocator, class GrowthPolicy, class BoundsCheck>
+SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>& SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>::operator=(std::initializer_list<T> ilist) {
+	this->assign(ilist.begin(), ilist.end());
+	return *this;
+}
+
+//capacity
+template <class T, std::size_t N, class Allocator, class GrowthPolicy, class BoundsCheck>
+bool SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>::is_inline() const noexcept {
+	return this->_allocator.is_inline(this->_data);
+}
+
+template <class T, std::size_t N, class Allocator, class GrowthPolicy, class BoundsCheck>
+void SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>::shrink_to_fit() {
+	if (is_inline()) {
+		return;
+	}
+	base_type::shrink_to_fit();
+	claim_inline_buffer();
+}
+
+//modifiers
+template <class T, std::size_t N, class Allocator, class GrowthPolicy, class BoundsCheck>
+void SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>::swap(SmallVector& other) {
+	if (this == &other) {
+		return;
+	}
+	if (!is_inline() && !other.is_inline() && can_steal_from(other)) {
+		base_type::swap(other);
+		return;
+	}
+	SmallVector tmp(std::move(other));
+	other = std::move(*this);
+	*this = std::move(tmp);
+}
+
+//gives the inline buffer to an empty Vector and reports all N slots as
+//capacity, even if the Vector asked its allocator for fewer
+template <class T, std::size_t N, class Allocator, class GrowthPolicy, class BoundsCheck>
+void SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>::claim_inline_buffer() noexcept {
+	if (this->_data == nullptr) {
+		buffer_type::in_use = true;
+		this->_data = buffer_type::inline_data();
+		this->_capacity = N;
+	}
+	else if (is_inline()) {
+		this->_capacity = N;
+	}
+}
+
+//expects an empty vector, returns heap memory and switches back to the inline buffer
+template <class T, std::size_t N, class Allocator, class GrowthPolicy, class BoundsCheck>
+void SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>::release_heap_storage() noexcept {
+	if (is_inline()) {
+		return;
+	}
+	this->deallocate_storage(this->_data, this->_capacity);
+	this->_data = nullptr;
+	this->_capacity = 0;
+	claim_inline_buffer();
+}
+
+//moves the content of other into this empty vector: heap storage is stolen
+//when both sides use interchangeable heap allocators, inline elements are relocated
+template <class T, std::size_t N, class Allocator, class GrowthPolicy, class BoundsCheck>
+void SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>::take(SmallVector& other) {
+	if (!other.is_inline() && can_steal_from(other)) {
+		this->deallocate_storage(this->_data, this->_capacity);
+		this->_data = other._data;
+		this->_size = other._size;
+		this->_capacity = other._capacity;
+		other._data = nullptr;
+		other._size = 0;
+		other._capacity = 0;
+		other.claim_inline_buffer();
+		return;
+	}
+	this->reserve(other._size);
+	relocate(this->_allocator, other._data, other._size, this->_data);
+	this->_size = other._size;
+	other._size = 0;
+	other.release_heap_storage();
+}
+
+template <class T, std::size_t N, class Allocator, class GrowthPolicy, class BoundsCheck>
+bool SmallVector<T, N, Allocator, GrowthPolicy, BoundsCheck>::can_steal_from(const SmallVector& other) const noexcept {
+	return this->_allocator.heap() == other._allocator.heap();
+}
+
+//operators
+template <class U, std::size_t M, class A, class G, class C>
+bool operator==(const SmallVector<U, M, A, G, C>& lhs, const SmallVector<U, M, A, G, C>& rhs) {
+	using base_type = typename SmallVector<U, M, A, G, C>::base_type;
+	return static_cast<const base_type&>(lhs) == static_cast<const base_type&>(rhs);
+}
+
+template <class U, std::size_t M, class A, class G, class C>
+bool operator!=(const SmallVector<U, M, A, G, C>& lhs, const SmallVector<U, M, A, G, C>& rhs) {
+	using base_type = typename SmallVector<U, M, A, G, C>::base_type;
+	return static_cast<const base_type&>(lhs) != static_cast<const base_type&>(rhs);
+}
+
+template <class U, std::size_t M, class A, class G, class C>
+bool operator<(const SmallVector<U, M, A, G, C>& lhs, const SmallVector<U, M, A, G, C>& rhs) {
+	using base_type = typename SmallVector<U, M, A, G, C>::base_type;
+	return static_cast<const base_type&>(lhs) < static_cast<const base_type&>(rhs);
+}
+
+template <class U, std::size_t M, class A, class G, class C>
+bool operator<=(const SmallVector<U, M, A, G, C>& lhs, const SmallVector<U, M, A, G, C>& rhs) {
+	using base_type = typename SmallVector<U, M, A, G, C>::base_type;
+	return static_cast<const base_type&>(lhs) <= static_cast<const base_type&>(rhs);
+}
+
+template <class U, std::size_t M, class A, class G, class C>
+bool operator>(const SmallVector<U, M, A, G, C>& lhs, const SmallVector<U, M, A, G, C>& rhs) {
+	using base_type = typename SmallVector<U, M, A, G, C>::base_type;
+	return static_cast<const base_type&>(lhs) > static_cast<const base_type&>(rhs);
+}
+
+template <class U, std::size_t M, class A, class G, class C>
+bool operator>=(const SmallVector<U, M, A, G, C>& lhs, const SmallVector<U, M, A, G, C>& rhs) {
+	using base_type = typename SmallVector<U, M, A, G, C>::base_type;
+	return static_cast<const base_type&>(lhs) >= static_cast<const base_type&>(rhs);
+}
\ No newline at end of file
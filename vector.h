@@ -6,14 +6,18 @@
 #include <iostream>
 #include <iterator>
 #include <utility>
-#include <ctgmath>
 #include <initializer_list>
 #include <vector>
 #include "Iterator.h"
+#include "Relocation.h"
+#include "AllocatorHooks.h"
+#include "GrowthPolicy.h"
+#include "BoundsCheck.h"
 
-template <typename T, typename Allocator = std::allocator<T>> class Vector;
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = OneAndHalfGrowth,
+	typename BoundsCheck = DefaultBoundsCheck> class Vector;
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy, typename BoundsCheck>
 class Vector {
 public:
 	using value_type = T;
@@ -49,9 +53,9 @@ public:
 	~Vector();
 
 	//value assign
-	Vector<T, Allocator>& operator=(const Vector<T, Allocator>& other);
-	Vector<T, Allocator>& operator=(Vector<T, Allocator>&& other);
-	Vector<T, Allocator>& operator=(std::initializer_list<T> ilist);
+	Vector<T, Allocator, GrowthPolicy, BoundsCheck>& operator=(const Vector<T, Allocator, GrowthPolicy, BoundsCheck>& other);
+	Vector<T, Allocator, GrowthPolicy, BoundsCheck>& operator=(Vector<T, Allocator, GrowthPolicy, BoundsCheck>&& other);
+	Vector<T, Allocator, GrowthPolicy, BoundsCheck>& operator=(std::initializer_list<T> ilist);
 
 	template <class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
 	void assign(InputIterator first, InputIterator last);
@@ -114,79 +118,100 @@ public:
 	void pop_back();
 	void resize(size_type count);
 	void resize(size_type count, const value_type& value);
+	//new elements of trivial types keep whatever the storage held, others are value-initialized
+	void resize_default_init(size_type count);
+	//op(data(), count) writes the elements straight into the storage and returns the new size,
+	//which must not exceed count; elements past the old size start uninitialized
+	template <class Operation>
+	void resize_and_overwrite(size_type count, Operation op);
 	void swap(Vector& other);
 
 	//operators
-	template< class T, class Alloc >
-	friend bool operator==(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs);
+	template< class U, class Alloc, class Growth, class Check >
+	friend bool operator==(const Vector<U, Alloc, Growth, Check>& lhs, const Vector<U, Alloc, Growth, Check>& rhs);
 
-	template< class T, class Alloc >
-	friend bool operator!=(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs);
+	template< class U, class Alloc, class Growth, class Check >
+	friend bool operator!=(const Vector<U, Alloc, Growth, Check>& lhs, const Vector<U, Alloc, Growth, Check>& rhs);
 
-	template< class T, class Alloc >
-	friend bool operator<(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs);
+	template< class U, class Alloc, class Growth, class Check >
+	friend bool operator<(const Vector<U, Alloc, Growth, Check>& lhs, const Vector<U, Alloc, Growth, Check>& rhs);
 
-	template< class T, class Alloc >
-	friend bool operator<=(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs);
+	template< class U, class Alloc, class Growth, class Check >
+	friend bool operator<=(const Vector<U, Alloc, Growth, Check>& lhs, const Vector<U, Alloc, Growth, Check>& rhs);
 
-	template< class T, class Alloc >
-	friend bool operator>(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs);
+	template< class U, class Alloc, class Growth, class Check >
+	friend bool operator>(const Vector<U, Alloc, Growth, Check>& lhs, const Vector<U, Alloc, Growth, Check>& rhs);
 
-	template< class T, class Alloc >
-	friend bool operator>=(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs);
+	template< class U, class Alloc, class Growth, class Check >
+	friend bool operator>=(const Vector<U, Alloc, Growth, Check>& lhs, const Vector<U, Alloc, Growth, Check>& rhs);
 
-private:
-	const double _increaseCoefficient = 1.5;
+protected:
 	allocator_type _allocator;
 	size_type _size;
 	size_type _capacity;
 	pointer _data; 
 
+	//value-initialized elements are already in the storage of allocate_default_storage
+	static constexpr bool zeroed_value_init = has_allocate_zeroed<Allocator>::value && is_trivially_zeroable_v<T>;
+
+	pointer allocate_storage(size_type count);
+	pointer allocate_default_storage(size_type count);
+	void deallocate_storage(pointer data, size_type count);
 	void fill_default(size_type from = 0);         
 	void fill_value(const T& value, size_type from = 0);
 	void copy_vector(const Vector& other);
 	template<class It>
 	void copy_from_iterator(It first, It last);
-	void destruct_data(size_type from = 0);
+	void destruct_data(size_type from = 0) noexcept;
 	void reserve_to_add(size_type size = 1);
+	void reallocate(size_type new_cap, bool try_in_place = true);
 	void move_to_new(pointer data);
 	void shift_right(const_iterator pos, difference_type distance = 1);
 	void shift_left(const_iterator pos, difference_type distance = 1);
+	void steal_storage(Vector& other) noexcept;
+	void move_elements(Vector& other);
 };
 
+//Vector only holds a pointer to its heap buffer, so it can be memcpy'ed
+//whenever its allocator can
+template <typename T, typename Allocator, typename GrowthPolicy, typename BoundsCheck>
+struct is_trivially_relocatable<Vector<T, Allocator, GrowthPolicy, BoundsCheck>> : is_trivially_relocatable<Allocator> {};
+
 //constructors
-template<typename T, typename Allocator>
-Vector<T, Allocator>::Vector(const Allocator& alloc)
+template<typename T, typename Allocator, typename GrowthPolicy, typename BoundsCheck>
+Vector<T, Allocator, GrowthPolicy, BoundsCheck>::Vector(const Allocator& alloc)
 	: _allocator(alloc), 
 	_size(0),
 	_capacity(_size),
-	_data(std::allocator_traits<Allocator>::allocate(_allocator, _capacity)) {}
+	_data(allocate_storage(_capacity)) {}
 
-template<class T, class Allocator>
-Vector<T, Allocator>::Vector(size_type count, const Allocator& alloc)
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+Vector<T, Allocator, GrowthPolicy, BoundsCheck>::Vector(size_type count, const Allocator& alloc)
 	: _allocator(alloc),
-	_data(std::allocator_traits<Allocator>::allocate(_allocator, count)),
+	_data(allocate_default_storage(count)),
 	_size(count),
 	_capacity(count)
 {
-	fill_default();
+	if constexpr (!zeroed_value_init) {
+		fill_default();
+	}
 }
 
-template<class T, class Allocator>
-Vector<T, Allocator>::Vector(Vector::size_type count, const T& value, const Allocator& alloc)
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+Vector<T, Allocator, GrowthPolicy, BoundsCheck>::Vector(Vector::size_type count, const T& value, const Allocator& alloc)
 	: _allocator(alloc),
-	_data(std::allocator_traits<Allocator>::allocate(_allocator, count)),
+	_data(allocate_storage(count)),
 	_size(count),
 	_capacity(count)
 {
 	fill_value(value);
 }
 
-template<class T, class Allocator>
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
 template<class InputIterator, class>
-Vector<T, Allocator>::Vector(InputIterator first, InputIterator last, const Allocator& alloc)
+Vector<T, Allocator, GrowthPolicy, BoundsCheck>::Vector(InputIterator first, InputIterator last, const Allocator& alloc)
 	: _allocator(alloc),
-	_data(std::allocator_traits<Allocator>::allocate(_allocator, std::distance(first, last))),
+	_data(allocate_storage(std::distance(first, last))),
 	_size(static_cast<size_type>(std::distance(first, last))),
 	_capacity(_size)
 {
@@ -196,20 +221,20 @@ Vector<T, Allocator>::Vector(InputIterator first, InputIterator last, const Allo
 	}
 }
 
-template<class T, class Allocator>
-Vector<T, Allocator>::Vector(const Vector& other)
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+Vector<T, Allocator, GrowthPolicy, BoundsCheck>::Vector(const Vector& other)
 	: _allocator(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.get_allocator())),
-	_data(std::allocator_traits<Allocator>::allocate(_allocator, other._capacity)),
+	_data(allocate_storage(other._capacity)),
 	_size(other._size),
 	_capacity(other._capacity)
 {
 	copy_vector(other);
 }
 
-template<class T, class Allocator>
-Vector<T, Allocator>::Vector(const Vector& other, const Allocator& alloc)
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+Vector<T, Allocator, GrowthPolicy, BoundsCheck>::Vector(const Vector& other, const Allocator& alloc)
 	: _allocator(alloc),
-	_data(std::allocator_traits<Allocator>::allocate(_allocator, other._capacity)),
+	_data(allocate_storage(other._capacity)),
 	_size(other._size),
 	_capacity(other._capacity)
 {
@@ -217,152 +242,198 @@ Vector<T, Allocator>::Vector(const Vector& other, const Allocator& alloc)
 	copy_vector(other);
 }
 
-template<class T, class Allocator>
-Vector<T, Allocator>::Vector(Vector&& other) noexcept
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+Vector<T, Allocator, GrowthPolicy, BoundsCheck>::Vector(Vector&& other) noexcept
 	:  _allocator(std::move(other._allocator)),
-	_data(std::move(other._data)),
-	_size(std::move(other._size)),
-	_capacity(std::move(other._capacity))
+	_data(nullptr),
+	_size(0),
+	_capacity(0)
 {
-	other._size = 0;
-	other._capacity = 0;
-	other._data = nullptr;
+	steal_storage(other);
 }
 
-template<class T, class Allocator>
-Vector<T, Allocator>::Vector(Vector&& other, const Allocator& alloc)
+//storage can only be taken over when alloc is able to free it
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+Vector<T, Allocator, GrowthPolicy, BoundsCheck>::Vector(Vector&& other, const Allocator& alloc)
 	: _allocator(alloc),
-	_data(std::move(other._data)),
-	_size(std::move(other._size)),
-	_capacity(std::move(other._capacity))
+	_data(nullptr),
+	_size(0),
+	_capacity(0)
 {
-	other._size = 0;
-	other._capacity = 0;
-	other._data = nullptr;
+	if (_allocator == other._allocator) {
+		steal_storage(other);
+	}
+	else {
+		move_elements(other);
+	}
 }
 
-template<class T, class Allocator>
-Vector<T, Allocator>::Vector(std::initializer_list<T> init, const Allocator& alloc)
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+Vector<T, Allocator, GrowthPolicy, BoundsCheck>::Vector(std::initializer_list<T> init, const Allocator& alloc)
 	: _allocator(alloc),
-	_data(std::allocator_traits<Allocator>::allocate(_allocator, init.size())),
+	_data(allocate_storage(init.size())),
 	_size(init.size()),
 	_capacity(init.size())
 {
 	copy_from_iterator(init.begin(), init.end());
 }
 
-template<class T, class Allocator>
-Vector<T, Allocator>::~Vector() {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+Vector<T, Allocator, GrowthPolicy, BoundsCheck>::~Vector() {
 	destruct_data();
+	deallocate_storage(_data, _capacity);
 }
 
 //value assign
-template<class T, class Allocator>
-Vector<T, Allocator>& Vector<T, Allocator>::operator=(const Vector<T, Allocator>& other) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+Vector<T, Allocator, GrowthPolicy, BoundsCheck>& Vector<T, Allocator, GrowthPolicy, BoundsCheck>::operator=(const Vector<T, Allocator, GrowthPolicy, BoundsCheck>& other) {
+	if (this == &other) {
+		return *this;
+	}
+	//the copy is built before the old storage is released, so a throwing
+	//allocation or element copy leaves this vector as it was
+	constexpr bool propagate = std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value;
+	allocator_type allocator = propagate ? other._allocator : _allocator;
+	pointer new_data = nullptr;
+	if (other._capacity != 0) {
+		new_data = std::allocator_traits<Allocator>::allocate(allocator, other._capacity);
+	}
+	size_type constructed = 0;
+	try {
+		for (; constructed < other._size; constructed++) {
+			std::allocator_traits<Allocator>::construct(allocator, new_data + constructed, other._data[constructed]);
+		}
+	}
+	catch (...) {
+		for (size_type i = 0; i < constructed; i++) {
+			std::allocator_traits<Allocator>::destroy(allocator, new_data + i);
+		}
+		if (new_data != nullptr) {
+			std::allocator_traits<Allocator>::deallocate(allocator, new_data, other._capacity);
+		}
+		throw;
+	}
 	destruct_data();
-	_allocator = other._allocator;
-	_capacity = other._capacity;
+	deallocate_storage(_data, _capacity);
+	if constexpr (propagate) {
+		_allocator = other._allocator;
+	}
+	_data = new_data;
 	_size = other._size;
-	_data = std::allocator_traits<Allocator>::allocate(_allocator, other.capacity());
-	copy_vector(other);
+	_capacity = other._capacity;
 	return *this;
 }
 
-template<class T, class Allocator>
-Vector<T, Allocator>& Vector<T, Allocator>::operator=(Vector<T, Allocator>&& other) {
-	destruct_data();
-	_allocator = std::move(other._allocator);
-	_capacity = std::move(other._capacity);
-	_size = std::move(other._size);
-	_data = std::move(other._data);
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+Vector<T, Allocator, GrowthPolicy, BoundsCheck>& Vector<T, Allocator, GrowthPolicy, BoundsCheck>::operator=(Vector<T, Allocator, GrowthPolicy, BoundsCheck>&& other) {
+	if (this == &other) {
+		return *this;
+	}
+	if (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value || _allocator == other._allocator) {
+		destruct_data();
+		deallocate_storage(_data, _capacity);
+		if constexpr (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) {
+			_allocator = other._allocator;
+		}
+		_data = nullptr;
+		_size = 0;
+		_capacity = 0;
+		steal_storage(other);
+	}
+	else {
+		clear();
+		move_elements(other);
+	}
 	return *this;
 }
 
-template<class T, class Allocator>
-Vector<T, Allocator>& Vector<T, Allocator>::operator=(std::initializer_list<T> ilist) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+Vector<T, Allocator, GrowthPolicy, BoundsCheck>& Vector<T, Allocator, GrowthPolicy, BoundsCheck>::operator=(std::initializer_list<T> ilist) {
 	Vector tmp = Vector(std::move(ilist));
 	swap(tmp);
 	return *this;
 }
 
-template<class T, class Allocator>
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
 template<class InputIterator, class>
-void Vector<T, Allocator>::assign(InputIterator first, InputIterator last)
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::assign(InputIterator first, InputIterator last)
 {
-	destruct_data();
+	clear();
 	size_type size = std::distance(first, last);
 	reserve_to_add(size);
 	_size = size;
 	copy_from_iterator(first, last);
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::assign(size_type count, const T& value) {
-	destruct_data();
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::assign(size_type count, const T& value) {
+	clear();
 	reserve_to_add(count);
 	_size = count;
 	fill_value(value);
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::assign(std::initializer_list<T> ilist) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::assign(std::initializer_list<T> ilist) {
 	assign(ilist.begin(), ilist.end());
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::allocator_type Vector<T, Allocator>::get_allocator() const noexcept {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::allocator_type Vector<T, Allocator, GrowthPolicy, BoundsCheck>::get_allocator() const noexcept {
 	return _allocator;
 }
 
 //elemtnt acces
-template<class T, class Allocator>
-typename Vector<T, Allocator>::reference Vector<T, Allocator>::at(size_type pos) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::reference Vector<T, Allocator, GrowthPolicy, BoundsCheck>::at(size_type pos) {
 	if (pos < 0 || _size <= pos) {
 		throw std::out_of_range("   ");
 	}
 	return _data[pos];
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::const_reference Vector<T, Allocator>::at(size_type pos) const {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::const_reference Vector<T, Allocator, GrowthPolicy, BoundsCheck>::at(size_type pos) const {
 	if (pos < 0 || _size <= pos) {
 		throw std::out_of_range("   ");
 	}
 	return _data[pos];
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::reference Vector<T, Allocator>::operator[](size_type pos) {
-	return at(pos);
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::reference Vector<T, Allocator, GrowthPolicy, BoundsCheck>::operator[](size_type pos) {
+	BoundsCheck::check(pos, _size);
+	return _data[pos];
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::const_reference Vector<T, Allocator>::operator[](size_type pos) const {
-	return at(pos);
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::const_reference Vector<T, Allocator, GrowthPolicy, BoundsCheck>::operator[](size_type pos) const {
+	BoundsCheck::check(pos, _size);
+	return _data[pos];
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::reference Vector<T, Allocator>::front() {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::reference Vector<T, Allocator, GrowthPolicy, BoundsCheck>::front() {
 	return _data[0];
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::const_reference Vector<T, Allocator>::front() const {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::const_reference Vector<T, Allocator, GrowthPolicy, BoundsCheck>::front() const {
 	return _data[0];
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::reference Vector<T, Allocator>::back() {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::reference Vector<T, Allocator, GrowthPolicy, BoundsCheck>::back() {
 	return _data[_size - 1];
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::const_reference Vector<T, Allocator>::back() const {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::const_reference Vector<T, Allocator, GrowthPolicy, BoundsCheck>::back() const {
 	return _data[_size - 1];
 }
 
-template<class T, class Allocator>
-T* Vector<T, Allocator>::data() noexcept {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+T* Vector<T, Allocator, GrowthPolicy, BoundsCheck>::data() noexcept {
 	if (empty()) {
 		return nullptr;
 	}
@@ -371,8 +442,8 @@ T* Vector<T, Allocator>::data() noexcept {
 	}
 }
 
-template<class T, class Allocator>
-const T* Vector<T, Allocator>::data() const noexcept {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+const T* Vector<T, Allocator, GrowthPolicy, BoundsCheck>::data() const noexcept {
 	if (empty()) {
 		return nullptr;
 	}
@@ -382,229 +453,228 @@ const T* Vector<T, Allocator>::data() const noexcept {
 }
 
 //iterators
-template<class T, class Allocator>
-typename Vector<T, Allocator>::iterator Vector<T, Allocator>::begin() noexcept {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::begin() noexcept {
 	return iterator(_data);
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::const_iterator Vector<T, Allocator>::begin() const noexcept {
-	return iterator(_data);
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::const_iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::begin() const noexcept {
+	return const_iterator(_data);
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::const_iterator Vector<T, Allocator>::cbegin() const noexcept {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::const_iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::cbegin() const noexcept {
 	return const_iterator(_data);
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::iterator Vector<T, Allocator>::end() noexcept {
-	return iterator(_data, _size);
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::end() noexcept {
+	return iterator(_data + _size);
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::const_iterator Vector<T, Allocator>::end() const noexcept {
-	return const_iterator(_data, _size);
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::const_iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::end() const noexcept {
+	return const_iterator(_data + _size);
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::const_iterator Vector<T, Allocator>::cend() const noexcept {
-	return const_iterator(_data, _size);
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::const_iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::cend() const noexcept {
+	return const_iterator(_data + _size);
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::reverse_iterator Vector<T, Allocator>::rbegin() noexcept {
-	return reverse_iterator(end())
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::reverse_iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::rbegin() noexcept {
+	return reverse_iterator(end());
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::const_reverse_iterator Vector<T, Allocator>::rbegin() const noexcept {
-	return const_reverse_iterator(end())
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::const_reverse_iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::rbegin() const noexcept {
+	return const_reverse_iterator(end());
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::const_reverse_iterator Vector<T, Allocator>::crbegin() const noexcept {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::const_reverse_iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::crbegin() const noexcept {
 	return const_reverse_iterator(end());
 }
-template<class T, class Allocator>
-typename Vector<T, Allocator>::reverse_iterator Vector<T, Allocator>::rend() noexcept {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::reverse_iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::rend() noexcept {
 	return reverse_iterator(begin());
 }
-template<class T, class Allocator>
-typename Vector<T, Allocator>::const_reverse_iterator Vector<T, Allocator>::rend() const noexcept {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::const_reverse_iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::rend() const noexcept {
 	return const_reverse_iterator(begin());
 }
-template<class T, class Allocator>
-typename Vector<T, Allocator>::const_reverse_iterator Vector<T, Allocator>::crend() const noexcept {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::const_reverse_iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::crend() const noexcept {
 	return const_reverse_iterator(begin());
 }
 
 //capacity
-template<class T, class Allocator>
-bool Vector<T, Allocator>::empty() const noexcept {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+bool Vector<T, Allocator, GrowthPolicy, BoundsCheck>::empty() const noexcept {
 	return _size == 0;
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::size_type Vector<T, Allocator>::size() const noexcept {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::size_type Vector<T, Allocator, GrowthPolicy, BoundsCheck>::size() const noexcept {
 	return _size;
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::size_type Vector<T, Allocator>::max_size() const noexcept {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::size_type Vector<T, Allocator, GrowthPolicy, BoundsCheck>::max_size() const noexcept {
 	return std::numeric_limits<size_type>::max() / sizeof(T);
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::reserve(size_type new_cap) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::reserve(size_type new_cap) {
 	if (new_cap > max_size()) {
 		throw std::length_error("   ");
 	}
 	if (new_cap <= _capacity) {
 		return;
 	}
-	auto new_data = std::allocator_traits<Allocator>::allocate(_allocator, new_cap);
-	move_to_new(new_data);
-	std::allocator_traits<Allocator>::deallocate(_allocator, _data, _capacity);
-	_data = new_data;
-	_capacity = new_cap;
+	reallocate(new_cap);
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::size_type Vector<T, Allocator>::capacity() const noexcept {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::size_type Vector<T, Allocator, GrowthPolicy, BoundsCheck>::capacity() const noexcept {
 	return _capacity;
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::shrink_to_fit() {
-	size_type extra_length = capacity_ - size_;
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::shrink_to_fit() {
+	size_type extra_length = _capacity - _size;
 	if (extra_length == 0) {
 		return;
 	}
-	pointer new_data = std::allocator_traits<Allocator>::allocate(_allocator, _size);
-	move_to_new(new_data);
-	std::allocator_traits<Allocator>::deallocate(_allocator, _data, _capacity);
-	_data = new_data;
-	_capacity = _size;
+	reallocate(_size);
 }
 
 //modifiers
-template<class T, class Allocator>
-void Vector<T, Allocator>::clear() noexcept {
-	for (size_type i = 0; i < _size; i++) {
-		std::allocator_traits<Allocator>::destroy(_allocator, _data + i);
-	}
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::clear() noexcept {
+	destruct_data();
 	_size = 0;
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::iterator Vector<T, Allocator>::insert(const_iterator pos, const T& value) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::insert(const_iterator pos, const T& value) {
+	size_type index = pos - cbegin();
 	shift_right(pos);
-	std::allocator_traits<Allocator>::construct(_allocator, _data + pos.pos(), std::forward<const T&>(value));
+	std::allocator_traits<Allocator>::construct(_allocator, _data + index, std::forward<const T&>(value));
 	_size++;
-	return iterator(_data, pos.pos());
+	return iterator(_data + index);
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::iterator Vector<T, Allocator>::insert(const_iterator pos, T&& value) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::insert(const_iterator pos, T&& value) {
+	size_type index = pos - cbegin();
 	shift_right(pos);
-	std::allocator_traits<Allocator>::construct(_allocator, _data + pos.pos(), std::forward<T&&>(value));
+	std::allocator_traits<Allocator>::construct(_allocator, _data + index, std::forward<T&&>(value));
 	_size++;
-	return iterator(_data, pos.pos());
+	return iterator(_data + index);
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::iterator Vector<T, Allocator>::insert(const_iterator pos, size_type count, const T& value) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::insert(const_iterator pos, size_type count, const T& value) {
+	size_type index = pos - cbegin();
 	shift_right(pos, count);
-	for (size_type i = pos.pos(); i < pos.pos() + count; i++) {
+	for (size_type i = index; i < index + count; i++) {
 		std::allocator_traits<Allocator>::construct(_allocator, _data + i, std::forward<const T&>(value));
 	}
 	_size += count;
-	return iterator(_data, pos.pos());
+	return iterator(_data + index);
 }
 
-template<class T, class Allocator>
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
 template<class InputIterator, class>
-typename Vector<T, Allocator>::iterator Vector<T, Allocator>::insert(Vector::const_iterator pos, InputIterator first, InputIterator last)
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::insert(Vector::const_iterator pos, InputIterator first, InputIterator last)
 {
 	size_type size = last - first;
+	size_type index = pos - cbegin();
 	shift_right(pos, size);
-	size_type i = pos.pos();
+	size_type i = index;
 	for (auto it = first; it != last; it++) {
 		std::allocator_traits<Allocator>::construct(_allocator, _data + i, *it);
 		i++;
 	}
 	_size += size;
-	return iterator(_data, pos.pos());
+	return iterator(_data + index);
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::iterator Vector<T, Allocator>::insert(const_iterator pos, std::initializer_list<T> ilist) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::insert(const_iterator pos, std::initializer_list<T> ilist) {
 	return insert(pos, ilist.begin(), ilist.end());
 }
 
-template<class T, class Allocator>
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
 template< class... Args >
-typename Vector<T, Allocator>::iterator Vector<T, Allocator>::emplace(const_iterator pos, Args&&... args) {
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::emplace(const_iterator pos, Args&&... args) {
+	size_type index = pos - cbegin();
 	shift_right(pos);
-	std::allocator_traits<Allocator>::construct(_allocator, _data + pos.pos(), std::forward<Args&&>(args)...);
+	std::allocator_traits<Allocator>::construct(_allocator, _data + index, std::forward<Args&&>(args)...);
 	_size++;
-	return iterator(_data, pos.pos());
+	return iterator(_data + index);
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::iterator Vector<T, Allocator>::erase(const_iterator pos) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::erase(const_iterator pos) {
 	if (empty()) {
 		return end();
 	}
+	size_type index = pos - cbegin();
 	shift_left(pos + 1);
 	_size--;
-	return iterator(_data, pos.pos());
+	return iterator(_data + index);
 }
 
-template<class T, class Allocator>
-typename Vector<T, Allocator>::iterator Vector<T, Allocator>::erase(const_iterator first, const_iterator last) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::iterator Vector<T, Allocator, GrowthPolicy, BoundsCheck>::erase(const_iterator first, const_iterator last) {
 	if (empty()) {
 		return end();
 	}
+	size_type index = first - cbegin();
 	shift_left(last, last - first);
 	_size -= last - first;
-	return iterator(_data, last.pos() - (last - first));
+	return iterator(_data + index);
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::push_back(const T& value) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::push_back(const T& value) {
 	reserve_to_add();
 	std::allocator_traits<Allocator>::construct(_allocator, _data + _size, std::forward<const T&>(value));
 	_size++;
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::push_back(T&& value) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::push_back(T&& value) {
 	reserve_to_add();
 	std::allocator_traits<Allocator>::construct(_allocator, _data + _size, std::forward<T&&>(value));
 	_size++;
 }
 
-template<class T, class Allocator>
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
 template< class... Args >
-void Vector<T, Allocator>::emplace_back(Args&&... args) {
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::emplace_back(Args&&... args) {
 	reserve_to_add();
 	std::allocator_traits<Allocator>::construct(_allocator, _data + _size, std::forward<Args&&>(args)...);
 	_size++;
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::pop_back() {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::pop_back() {
 	if (empty()) {
 		return;
 	}
 	_size--;
-	std::allocator_traits<Allocator>::destroy(_allocator, _data + _size);
+	if constexpr (!is_trivially_destroyed_v<Allocator, T>) {
+		std::allocator_traits<Allocator>::destroy(_allocator, _data + _size);
+	}
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::resize(size_type count) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::resize(size_type count) {
 	if (count == _size) {
 		return;
 	}
@@ -613,20 +683,39 @@ void Vector<T, Allocator>::resize(size_type count) {
 		_size = count;
 		return;
 	}
+	//an allocator that grows blocks in place or by remapping hands out the new tail zeroed,
+	//so only the slack of the old block is cleared. Otherwise storage that has to move
+	//anyway is taken zeroed, and only the old elements are copied.
+	if constexpr (zeroed_value_init) {
+		if (count > _capacity) {
+			if constexpr (has_try_expand<Allocator>::value || has_reallocate<Allocator>::value) {
+				if (_data != nullptr) {
+					size_type old_capacity = _capacity;
+					reallocate(count);
+					std::memset(static_cast<void*>(_data + _size), 0, (old_capacity - _size) * sizeof(T));
+					_size = count;
+					return;
+				}
+			}
+			pointer new_data = allocate_default_storage(count);
+			move_to_new(new_data);
+			deallocate_storage(_data, _capacity);
+			_data = new_data;
+			_capacity = count;
+			_size = count;
+			return;
+		}
+	}
 	if (count > _capacity) {
-		auto new_data = std::allocator_traits<Allocator>::allocate(_allocator, count);
-		move_to_new(new_data);
-		std::allocator_traits<Allocator>::deallocate(_allocator, _data, _capacity);
-		_data = new_data;
-		_capacity = count;
+		reallocate(count);
 	}
 	size_type old_size = _size;
 	_size = count;
 	fill_default(old_size);
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::resize(size_type count, const value_type& value) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::resize(size_type count, const value_type& value) {
 	if (count == _size) {
 		return;
 	}
@@ -636,12 +725,7 @@ void Vector<T, Allocator>::resize(size_type count, const value_type& value) {
 		return;
 	}
 	if (count > _capacity) {
-		auto new_data = std::allocator_traits<Allocator>::allocate(_allocator, count);
-		move_to_new(new_data);
-
-		std::allocator_traits<Allocator>::deallocate(_allocator, _data, _capacity);
-		_data = new_data;
-		_capacity = count;
+		reallocate(count);
 	}
 	for (size_type i = _size; i < count; i++) {
 		std::allocator_traits<Allocator>::construct(_allocator, _data + i, value);
@@ -649,15 +733,50 @@ void Vector<T, Allocator>::resize(size_type count, const value_type& value) {
 	_size = count;
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::swap(Vector& other) {
+//grows like resize_and_overwrite, by the growth policy
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::resize_default_init(size_type count) {
+	if constexpr (is_trivially_default_initialized_v<Allocator, T>) {
+		if (count > _size) {
+			if (count > _capacity) {
+				reserve_to_add(count - _size);
+			}
+			_size = count;
+			return;
+		}
+	}
+	resize(count);
+}
+
+//storage grows by the growth policy, so decode loops that append chunk by chunk stay linear
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+template<class Operation>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::resize_and_overwrite(size_type count, Operation op) {
+	static_assert(is_trivially_default_initialized_v<Allocator, T> && is_trivially_destroyed_v<Allocator, T>,
+		"resize_and_overwrite needs elements that can be left uninitialized and dropped");
+	if (count > _capacity) {
+		reserve_to_add(count - _size);
+	}
+	size_type new_size = std::move(op)(_data, count);
+	if (new_size > count) {
+		throw std::length_error("resize_and_overwrite: the operation returned more than count");
+	}
+	_size = new_size;
+}
+
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::swap(Vector& other) {
+	//as with std::vector, swapping unequal allocators that do not propagate is undefined
+	if constexpr (std::allocator_traits<Allocator>::propagate_on_container_swap::value) {
+		std::swap(_allocator, other._allocator);
+	}
 	std::swap(_data, other._data);
 	std::swap(_size, other._size);
 	std::swap(_capacity, other._capacity);
 }
 
-template<class T, class Alloc>
-bool operator==(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs)
+template<class T, class Alloc, class Growth, class Check>
+bool operator==(const Vector<T, Alloc, Growth, Check>& lhs, const Vector<T, Alloc, Growth, Check>& rhs)
 {
 	if (lhs._size != rhs._size) {
 		return false;
@@ -675,74 +794,90 @@ bool operator==(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs)
 	return true;
 }
 
-template<class T, class Alloc>
-bool operator<(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs)
+template<class T, class Alloc, class Growth, class Check>
+bool operator<(const Vector<T, Alloc, Growth, Check>& lhs, const Vector<T, Alloc, Growth, Check>& rhs)
 {
-	auto size = std::min(lhs.size(), rhs.size());
-
-	for (typename vector<T, Alloc>::size_type i = 0; i < size; i++) {
-		if (lhs[i] < rhs[i]) {
-			return true;
-		}
-	}
-	return lhs.size() < rhs.size();
+	return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
-template<class T, class Alloc>
-bool operator!=(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs)
+template<class T, class Alloc, class Growth, class Check>
+bool operator!=(const Vector<T, Alloc, Growth, Check>& lhs, const Vector<T, Alloc, Growth, Check>& rhs)
 {
 	return !(lhs == rhs);
 }
 
-template<class T, class Alloc>
-bool operator> (const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs)
+template<class T, class Alloc, class Growth, class Check>
+bool operator> (const Vector<T, Alloc, Growth, Check>& lhs, const Vector<T, Alloc, Growth, Check>& rhs)
 {
 	return rhs < lhs;
 }
 
-template<class T, class Alloc>
-bool operator<=(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs)
+template<class T, class Alloc, class Growth, class Check>
+bool operator<=(const Vector<T, Alloc, Growth, Check>& lhs, const Vector<T, Alloc, Growth, Check>& rhs)
 {
-	auto size = std::min(lhs.size(), rhs.size());
+	return !(rhs < lhs);
+}
 
-	for (typename vector<T, Alloc>::size_type i = 0; i < size; i++) {
-		if (lhs[i] < rhs[i]) {
-			return true;
+template<class T, class Alloc, class Growth, class Check>
+bool operator>=(const Vector<T, Alloc, Growth, Check>& lhs, const Vector<T, Alloc, Growth, Check>& rhs)
+{
+	return rhs <= lhs;
+}
+
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::pointer Vector<T, Allocator, GrowthPolicy, BoundsCheck>::allocate_storage(size_type count) {
+	if (count == 0) {
+		return nullptr;
+	}
+	return std::allocator_traits<Allocator>::allocate(_allocator, count);
+}
+
+//zero pages from the allocate_zeroed hook, untouched until the elements are used
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+typename Vector<T, Allocator, GrowthPolicy, BoundsCheck>::pointer Vector<T, Allocator, GrowthPolicy, BoundsCheck>::allocate_default_storage(size_type count) {
+	if constexpr (zeroed_value_init) {
+		if (count == 0) {
+			return nullptr;
 		}
+		return _allocator.allocate_zeroed(count);
+	}
+	else {
+		return allocate_storage(count);
 	}
-	return lhs.size() == rhs.size();
 }
 
-template<class T, class Alloc>
-bool operator>=(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs)
-{
-	return rhs <= lhs;
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::deallocate_storage(pointer data, size_type count) {
+	if (data == nullptr) {
+		return;
+	}
+	std::allocator_traits<Allocator>::deallocate(_allocator, data, count);
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::fill_default(size_type from) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::fill_default(size_type from) {
 	for (size_type i = from; i < _size; i++) {
 		std::allocator_traits<Allocator>::construct(_allocator, _data + i);
 	}
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::fill_value(const T& value, size_type from) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::fill_value(const T& value, size_type from) {
 	for (size_type i = from; i < _size; i++) {
 		std::allocator_traits<Allocator>::construct(_allocator, _data + i, value);
 	}
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::copy_vector(const Vector& other) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::copy_vector(const Vector& other) {
 	for (size_type i = 0; i < other.size(); i++) {
 		std::allocator_traits<Allocator>::construct(_allocator, _data + i, other[i]);
 	}
 }
 
-template<class T, class Allocator>
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
 template<class It>
-void Vector<T, Allocator>::copy_from_iterator(It first, It last) {
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::copy_from_iterator(It first, It last) {
 	size_type i = 0;
 	for (auto it = first; it != last; it++) {
 		std::allocator_traits<Allocator>::construct(_allocator, _data + i, *it);
@@ -750,53 +885,137 @@ void Vector<T, Allocator>::copy_from_iterator(It first, It last) {
 	}
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::destruct_data(size_type from) {
-	for (size_type i = from; i < _size; i++) {
-		std::allocator_traits<Allocator>::destroy(_allocator, _data + i);
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::destruct_data(size_type from) noexcept {
+	if constexpr (!is_trivially_destroyed_v<Allocator, T>) {
+		for (size_type i = from; i < _size; i++) {
+			std::allocator_traits<Allocator>::destroy(_allocator, _data + i);
+		}
 	}
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::reserve_to_add(size_type size) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::reserve_to_add(size_type size) {
 	size_type needed_capacity = _size + size;
 	if (_capacity < needed_capacity) {
-		size_type new_capacity = static_cast<size_type>(std::floor(needed_capacity * _increaseCoefficient));
+		size_type new_capacity = GrowthPolicy::next_capacity(needed_capacity, sizeof(T));
+		//a block that can not take the whole growth step in place may still take what is needed,
+		//unless the allocator moves it cheaply, then the next push_back would pay again
+		if constexpr (has_try_expand<Allocator>::value) {
+			if (_data != nullptr && new_capacity <= max_size()) {
+				if (allocator_try_expand(_allocator, _data, _capacity, new_capacity)) {
+					_capacity = new_capacity;
+					return;
+				}
+				constexpr bool cheap_move = has_reallocate<Allocator>::value && is_trivially_relocatable_v<T>;
+				if (!cheap_move && allocator_try_expand(_allocator, _data, _capacity, needed_capacity)) {
+					_capacity = needed_capacity;
+					return;
+				}
+				//the block was already offered the growth step, do not ask again
+				reallocate(new_capacity, false);
+				return;
+			}
+		}
 		reserve(new_capacity);
 	}
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::move_to_new(pointer data) {
-	for (size_type i = 0; i < _size; i++) {
-		std::allocator_traits<Allocator>::construct(_allocator, data + i, std::move(_data[i]));
-		std::allocator_traits<Allocator>::destroy(_allocator, _data + i);
+//growing storage is first offered to the allocator's try_expand hook, if it has one,
+//so the elements do not have to move. Elements that are moved by copying their
+//bytes are left to the allocator's reallocate hook, e.g. mremap in MmapAllocator.
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::reallocate(size_type new_cap, bool try_in_place) {
+	if (try_in_place && new_cap > _capacity && _data != nullptr && allocator_try_expand(_allocator, _data, _capacity, new_cap)) {
+		_capacity = new_cap;
+		return;
+	}
+	if constexpr (has_reallocate<Allocator>::value && is_trivially_relocatable_v<T>) {
+		if (_data != nullptr && new_cap != 0) {
+			_data = _allocator.reallocate(_data, _capacity, new_cap);
+			_capacity = new_cap;
+			return;
+		}
+	}
+	pointer new_data = allocate_storage(new_cap);
+	try {
+		move_to_new(new_data);
+	}
+	catch (...) {
+		deallocate_storage(new_data, new_cap);
+		throw;
+	}
+	deallocate_storage(_data, _capacity);
+	_data = new_data;
+	_capacity = new_cap;
+}
+
+//old elements are destroyed only after all of them reached data, so a throwing
+//move or copy destroys what was built in data and leaves the vector untouched
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::move_to_new(pointer data) {
+	if constexpr (is_trivially_relocatable_v<T>) {
+		relocate(_allocator, _data, _size, data);
+	}
+	else {
+		size_type constructed = 0;
+		try {
+			for (; constructed < _size; constructed++) {
+				std::allocator_traits<Allocator>::construct(_allocator, data + constructed, std::move_if_noexcept(_data[constructed]));
+			}
+		}
+		catch (...) {
+			for (size_type i = 0; i < constructed; i++) {
+				std::allocator_traits<Allocator>::destroy(_allocator, data + i);
+			}
+			throw;
+		}
+		destruct_data();
 	}
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::shift_right(const_iterator pos, difference_type distance)
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::shift_right(const_iterator pos, difference_type distance)
 {
+	size_type index = pos - cbegin();
 	reserve_to_add(distance);
-	for (auto it = end() + distance - 1; it != pos + distance - 1; it--) {
-		std::allocator_traits<Allocator>::construct(_allocator, &*it, std::move(*(it - distance)));
-		std::allocator_traits<Allocator>::destroy(_allocator, &*(it - distance));
-	}
+	relocate_overlapping(_allocator, _data + index, _size - index, _data + index + distance);
 }
 
-template<class T, class Allocator>
-void Vector<T, Allocator>::shift_left(const_iterator pos, difference_type distance) {
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::shift_left(const_iterator pos, difference_type distance) {
 	if (distance == 0) {
 		return;
 	}
 
-	for (auto it = pos - distance; it != end() - distance; it++) {
-		std::allocator_traits<Allocator>::destroy(_allocator, &*it);
-		std::allocator_traits<Allocator>::construct(_allocator, &*it, std::move(*(it + distance)));
-		std::allocator_traits<Allocator>::destroy(_allocator, &*(it + distance));
+	size_type index = pos - cbegin();
+	if constexpr (!is_trivially_destroyed_v<Allocator, T>) {
+		for (size_type i = index - distance; i < index; i++) {
+			std::allocator_traits<Allocator>::destroy(_allocator, _data + i);
+		}
 	}
+	relocate_overlapping(_allocator, _data + index, _size - index, _data + index - distance);
+}
 
-	for (auto it = end() - distance; it != end(); it++) {
-		std::allocator_traits<Allocator>::destroy(_allocator, &*it);
+//takes over the buffer of other, expects this vector to hold no storage
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::steal_storage(Vector& other) noexcept {
+	_data = other._data;
+	_size = other._size;
+	_capacity = other._capacity;
+	other._data = nullptr;
+	other._size = 0;
+	other._capacity = 0;
+}
+
+//moves the elements of other into this empty vector through our own allocator,
+//other keeps its buffer for the allocator that owns it
+template<class T, class Allocator, class GrowthPolicy, class BoundsCheck>
+void Vector<T, Allocator, GrowthPolicy, BoundsCheck>::move_elements(Vector& other) {
+	if (_capacity < other._size) {
+		reallocate(other._size);
 	}
+	relocate(_allocator, other._data, other._size, _data);
+	_size = other._size;
+	other._size = 0;
 }
\ No newline at end of file